@@ -24,11 +24,31 @@
 #include "eeprom.h"
 #include "atomic.h"
 #include "Balancer.h"
+#include "Scheduler.h"
+#include "Profiler.h"
+#include "LoopStats.h"
 
 #define ANALOG_INPUTS_E_OUT_dt_FACTOR   50
 #define ANALOG_INPUTS_E_OUT_DIVIDER     100
+//slow interrupts per hour
+#define ANALOG_INPUTS_HOUR_BASIS        (1000000/TIMER_INTERRUPT_PERIOD_MICROSECONDS * 3600/TIMER_SLOW_INTERRUPT_INTERVAL)
+#define ANALOG_INPUTS_E_OUT_BASIS       (2*ANALOG_INPUTS_HOUR_BASIS)
+
+//noise = mean absolute difference of consecutive readings (fixed point)
+#define ANALOG_INPUTS_NOISE_SHIFT       4
+#define ANALOG_INPUTS_NOISE_AVR_SHIFT   3
+//stable band ~ 3 sigma of the difference ~ 4 * noise
+#define ANALOG_INPUTS_NOISE_BAND_SHIFT  2
+//a slow ramp must not widen the band above STABLE_MAX_ERROR
+#define ANALOG_INPUTS_NOISE_MAX         (AnalogInputs::STABLE_MAX_ERROR << (ANALOG_INPUTS_NOISE_SHIFT - ANALOG_INPUTS_NOISE_BAND_SHIFT))
+//stableCount_: readings within the band, the top bit is set
+//if one of them was outside the quarter band
+#define ANALOG_INPUTS_STABLE_NOISY      ((uint16_t)0x8000)
+#define ANALOG_INPUTS_STABLE_COUNT_MAX  ((uint16_t)0x7fff)
 
 #define ANALOG_INPUTS_ADC_MEASUREMENTS_COUNT (ANALOG_INPUTS_ADC_ROUND_MAX_COUNT*ANALOG_INPUTS_ADC_BURST_COUNT)
+//fast measurement: less rounds, used to take a snapshot of the inputs (IR test)
+#define ANALOG_INPUTS_ADC_FAST_ROUND_COUNT   (ANALOG_INPUTS_ADC_ROUND_MAX_COUNT/8)
 
 #if (1<<ANALOG_INPUTS_RESOLUTION) * ANALOG_INPUTS_ADC_MEASUREMENTS_COUNT > UINT32_MAX
 #error "avr sum don't fit into uint32_t"
@@ -60,12 +80,15 @@ namespace AnalogInputs {
     uint16_t connectedBalancePortCells;
 
     volatile uint16_t  i_avrCount_;
+    uint16_t avrRoundCount_ = ANALOG_INPUTS_ADC_ROUND_MAX_COUNT;
     volatile uint32_t  i_avrSum_[PHYSICAL_INPUTS];
     volatile ValueType i_adc_[PHYSICAL_INPUTS];
 
     ValueType avrAdc_[PHYSICAL_INPUTS];
     ValueType real_[ALL_INPUTS];
+    WideValueType wideReal_[Eout - Pout + 1];
     uint16_t stableCount_[ALL_INPUTS];
+    uint16_t noise_[ALL_INPUTS];
 
     uint16_t calculationCount_;
 
@@ -79,9 +102,12 @@ namespace AnalogInputs {
     uint16_t    deltaStartTimeU16_;
     bool        enable_deltaVoutMax_;
 
-    uint32_t    i_charge_;
-    uint32_t    i_Eout_;
-    uint8_t     i_Eout_dt_;
+    //accumulators: remainder below one unit + whole units
+    uint32_t        i_charge_;
+    WideValueType   i_chargeUnits_;
+    uint32_t        i_Eout_;
+    WideValueType   i_EoutUnits_;
+    uint8_t         i_Eout_dt_;
 
     void _resetAvr();
     void _resetDeltaAvr();
@@ -89,26 +115,84 @@ namespace AnalogInputs {
     void reset();
     void resetDelta();
     void resetStable();
+    void finalizeVirtual(Name name);
 
 
     ValueType getAvrADCValue(Name name)     { return avrAdc_[name];   }
-    ValueType getRealValue(Name name)       { return real_[name]; }
+    ValueType getRealValue(Name name)       { finalizeVirtual(name); return real_[name]; }
     ValueType getADCValue(Name name)        { RETURN_ATOMIC(i_adc_[name]) }
     bool isPowerOn() { return on_; }
+    bool isFastMeasurement()                { return avrRoundCount_ != ANALOG_INPUTS_ADC_ROUND_MAX_COUNT; }
     uint16_t getFullMeasurementCount()      { return calculationCount_; }
     ValueType getDeltaLastT()               { return deltaLastT_;}
     ValueType getDeltaCount()               { return deltaCount_;}
     void enableDeltaVoutMax(bool enable)    { enable_deltaVoutMax_ = enable; }
 
-    uint16_t getStableCount(Name name)      { return stableCount_[name]; };
-    bool isStable(Name name)                { return getStableCount(name) >= STABLE_MIN_VALUE; };
+    uint16_t getStableCount(Name name)      { finalizeVirtual(name); return stableCount_[name] & ANALOG_INPUTS_STABLE_COUNT_MAX; };
+    //readings within the quarter band are a stronger evidence of stability
+    bool isStable(Name name) {
+        uint16_t count = getStableCount(name);
+        if(stableCount_[name] & ANALOG_INPUTS_STABLE_NOISY)
+            return count >= STABLE_MIN_VALUE;
+        return count >= STABLE_MIN_VALUE - 1;
+    };
+    bool isWide(Name name)                  { return name >= Pout && name <= Eout; }
     void setReal(Name name, ValueType real);
+    void setWideReal(Name name, WideValueType real);
     void setRealBasedOnAvr(AnalogInputs::Name name);
 
     void finalizeDeltaMeasurement();
     void finalizeFullMeasurement();
     void finalizeFullVirtualMeasurement();
 
+    //virtual inputs are computed on demand, at most once per full measurement
+    enum VirtualGroup { VoutGroup, BalancerGroup, IoutGroup, PoutGroup, AccumulatedGroup, VIRTUAL_GROUPS };
+    static const uint8_t NoGroup = VIRTUAL_GROUPS;
+
+    void finalizeVout();
+    void finalizeBalancer();
+    void finalizeIout();
+    void finalizePout();
+    void finalizeAccumulated();
+
+    const VoidMethod groupMethod_[] PROGMEM = {
+        finalizeVout,
+        finalizeBalancer,
+        finalizeIout,
+        finalizePout,
+        finalizeAccumulated,
+    };
+
+    //virtual input -> group which computes it
+    const uint8_t virtualGroup_[] PROGMEM = {
+        VoutGroup,          //Vout
+        BalancerGroup,      //Vbalancer
+        BalancerGroup,      //VoutBalancer
+        BalancerGroup,      //VobInfo
+        BalancerGroup,      //VbalanceInfo
+        IoutGroup,          //Iout
+        PoutGroup,          //Pout
+        AccumulatedGroup,   //Cout
+        AccumulatedGroup,   //Eout
+        NoGroup,            //deltaVout - finalizeDeltaMeasurement
+        NoGroup,            //deltaVoutMax
+        NoGroup,            //deltaTextern
+        NoGroup,            //deltaLastCount
+        BalancerGroup,      //Vb1
+        BalancerGroup,
+        BalancerGroup,
+        BalancerGroup,
+        BalancerGroup,
+        BalancerGroup,
+#if MAX_BALANCE_CELLS > 6
+        BalancerGroup,
+        BalancerGroup,
+#endif
+    };
+
+    //full measurement (calculationCount_) in which the group was computed
+    uint16_t groupGeneration_[VIRTUAL_GROUPS];
+
     uint16_t getConnectedBalancePortCells();
     void saveBalancePortState()             { balancePortStateSaved_ = true; }
 
@@ -212,7 +296,7 @@ void AnalogInputs::_resetAvr()
         ANALOG_INPUTS_FOR_ALL_PHY(name) {
             i_avrSum_[name] = 0;
         }
-        i_avrCount_ = ANALOG_INPUTS_ADC_ROUND_MAX_COUNT;
+        i_avrCount_ = avrRoundCount_;
         ignoreLastResult_ = false;
     }
 }
@@ -245,11 +329,19 @@ void AnalogInputs::resetMeasurement()
     }
 }
 
+void AnalogInputs::setFastMeasurement(bool fast)
+{
+    avrRoundCount_ = fast ? ANALOG_INPUTS_ADC_FAST_ROUND_COUNT : ANALOG_INPUTS_ADC_ROUND_MAX_COUNT;
+    resetMeasurement();
+}
+
 void AnalogInputs::resetAccumulatedMeasurements()
 {
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
         i_charge_ = 0;
+        i_chargeUnits_ = 0;
         i_Eout_ = 0;
+        i_EoutUnits_ = 0;
         i_Eout_dt_ = ANALOG_INPUTS_E_OUT_dt_FACTOR;
     }
     setReal(deltaVoutMax, getVout());
@@ -258,7 +350,8 @@ void AnalogInputs::resetAccumulatedMeasurements()
     resetMeasurement();
     _resetDeltaAvr();
     deltaCount_ = 0;
-    setReal(Cout, 0);
+    setWideReal(Cout, 0);
+    setWideReal(Eout, 0);
     setReal(deltaVout, 0);
     setReal(deltaTextern, 0);
 }
@@ -266,6 +359,9 @@ void AnalogInputs::resetAccumulatedMeasurements()
 void AnalogInputs::reset()
 {
     calculationCount_ = 0;
+    //the virtual inputs are calculated again
+    for(uint8_t i = 0; i < VIRTUAL_GROUPS; i++)
+        groupGeneration_[i] = UINT16_MAX;
     resetAccumulatedMeasurements();
 }
 
@@ -341,6 +437,9 @@ AnalogInputs::ValueType AnalogInputs::reverseCalibrateValue(Name name, ValueType
 
 void AnalogInputs::initialize()
 {
+    ANALOG_INPUTS_FOR_ALL(name) {
+        noise_[name] = (STABLE_VALUE_ERROR << ANALOG_INPUTS_NOISE_SHIFT) >> ANALOG_INPUTS_NOISE_BAND_SHIFT;
+    }
     reset();
 }
 
@@ -358,6 +457,8 @@ AnalogInputs::Type AnalogInputs::getType(Name name)
         return Temperature;
     case Pout:
         return Power;
+    case Cout:
+        return Charge;
     case Eout:
         return Work;
     case deltaTextern:
@@ -371,58 +472,74 @@ AnalogInputs::Type AnalogInputs::getType(Name name)
 
 void AnalogInputs::printRealValue(Name name, uint8_t dig)
 {
-    ValueType x = getRealValue(name);
     Type t = getType(name);
-    lcdPrintAnalog(x, dig, t);
+    if(isWide(name)) {
+        lcdPrintAnalogWide(getWideRealValue(name), dig, t);
+    } else {
+        lcdPrintAnalog(getRealValue(name), dig, t);
+    }
 }
 
-static inline uint32_t toHoursBasis(uint32_t accumulator) {
-    uint32_t retu = accumulator;
-    retu /= 1000000/TIMER_INTERRUPT_PERIOD_MICROSECONDS
-        * 3600/TIMER_SLOW_INTERRUPT_INTERVAL;
-    return retu;
+AnalogInputs::WideValueType AnalogInputs::getWideRealValue(Name name)
+{
+    if(isWide(name)) {
+        finalizeVirtual(name);
+        return wideReal_[name - Pout];
+    }
+    return getRealValue(name);
 }
 
-AnalogInputs::ValueType AnalogInputs::getCharge()
+AnalogInputs::WideValueType AnalogInputs::getCharge()
 {
     //check units
     STATIC_ASSERT(ANALOG_AMP(1.0) == ANALOG_CHARGE(1.0));
 
-    uint32_t retu;
+    WideValueType retu;
     ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        retu = i_charge_;
+        retu = i_chargeUnits_;
     }
-    return toHoursBasis(retu);
+    return retu;
 }
 
 
-AnalogInputs::ValueType AnalogInputs::getEout()
+AnalogInputs::WideValueType AnalogInputs::getEout()
 {
-    uint32_t retu;
-    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
-        retu = i_Eout_;
-    }
-
     //check units
     STATIC_ASSERT(uint32_t(ANALOG_AMP(1.0))*ANALOG_VOLT(1.0)
             / (ANALOG_INPUTS_E_OUT_DIVIDER*ANALOG_INPUTS_E_OUT_dt_FACTOR)
             == 2 * ANALOG_WATTH(1.0));
-    retu /= 2;
 
-    return toHoursBasis(retu);
+    WideValueType retu;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        retu = i_EoutUnits_;
+    }
+    return retu;
 }
 
 void AnalogInputs::doSlowInterrupt()
 {
-    i_charge_ += getIout();
+    //the accumulators would overflow after ~130Ah (or ~2h at 65A),
+    //whole units are moved to a separate counter
+    //Iout and Vout are always up to date (see finalizeFullVirtualMeasurement),
+    //real_ is read directly to never compute virtual inputs in the interrupt
+    i_charge_ += real_[Iout];
+    while(i_charge_ >= ANALOG_INPUTS_HOUR_BASIS) {
+        i_charge_ -= ANALOG_INPUTS_HOUR_BASIS;
+        i_chargeUnits_++;
+    }
 
     if(--i_Eout_dt_ == 0) {
         i_Eout_dt_ = ANALOG_INPUTS_E_OUT_dt_FACTOR;
 
-        uint32_t P = getIout();
-        P *= getVout();
+        uint32_t P = real_[Iout];
+        P *= real_[Vout];
         uint32_t E_since_previous_measurement = P / ANALOG_INPUTS_E_OUT_DIVIDER;
         i_Eout_ += E_since_previous_measurement;
+        if(i_Eout_ >= ANALOG_INPUTS_E_OUT_BASIS) {
+            uint32_t units = i_Eout_ / ANALOG_INPUTS_E_OUT_BASIS;
+            i_EoutUnits_ += units;
+            i_Eout_ -= units * ANALOG_INPUTS_E_OUT_BASIS;
+        }
     }
 }
 
@@ -430,19 +547,30 @@ void AnalogInputs::doSlowInterrupt()
 
 void AnalogInputs::intterruptFinalizeMeasurement()
 {
-    if(i_avrCount_>0)
+    if(i_avrCount_>0) {
         i_avrCount_--;
+#ifdef ENABLE_LOOP_STATS
+        //the round has just finished
+        if(i_avrCount_ == 0)
+            LoopStats::adcDone();
+#endif
+    }
+    //posted until AnalogInputs::doIdle restarts the round
+    if(i_avrCount_ == 0)
+        Scheduler::post(Scheduler::AdcDone);
 }
 
 
 void AnalogInputs::doIdle()
 {
+    PROFILER_BEGIN(start);
     finalizeFullMeasurement();
+    PROFILER_END(FullMeasurement, start);
 }
 
 void AnalogInputs::setRealBasedOnAvr(AnalogInputs::Name name)
 {
-    avrAdc_[name] = i_avrSum_[name] / ANALOG_INPUTS_ADC_MEASUREMENTS_COUNT;
+    avrAdc_[name] = i_avrSum_[name] / (avrRoundCount_ * ANALOG_INPUTS_ADC_BURST_COUNT);
     ValueType real = calibrateValue(name, avrAdc_[name]);
     setReal(name, real);
 }
@@ -459,16 +587,22 @@ void AnalogInputs::finalizeFullMeasurement()
             if(isPowerOn()) {
                 calculationCount_++;
 
-                i_deltaAvrSumVoutPlus_    += i_avrSum_[Vout_plus_pin] >> ANALOG_INPUTS_ADC_DELTA_SHIFT;
-                i_deltaAvrSumVoutMinus_   += i_avrSum_[Vout_minus_pin] >> ANALOG_INPUTS_ADC_DELTA_SHIFT;
-                i_deltaAvrSumTextern_     += i_avrSum_[Textern] >> ANALOG_INPUTS_ADC_DELTA_SHIFT;
-                i_deltaAvrCount_ ++;
-                finalizeDeltaMeasurement();
+                if(!isFastMeasurement()) {
+                    i_deltaAvrSumVoutPlus_    += i_avrSum_[Vout_plus_pin] >> ANALOG_INPUTS_ADC_DELTA_SHIFT;
+                    i_deltaAvrSumVoutMinus_   += i_avrSum_[Vout_minus_pin] >> ANALOG_INPUTS_ADC_DELTA_SHIFT;
+                    i_deltaAvrSumTextern_     += i_avrSum_[Textern] >> ANALOG_INPUTS_ADC_DELTA_SHIFT;
+                    i_deltaAvrCount_ ++;
+                    finalizeDeltaMeasurement();
+                }
 
                 ANALOG_INPUTS_FOR_ALL_PHY(name) {
                     setRealBasedOnAvr(name);
                 }
                 finalizeFullVirtualMeasurement();
+#ifdef ENABLE_LOOP_STATS
+                LoopStats::newMeasurement();
+#endif
+                Scheduler::post(Scheduler::Measurement | Scheduler::WakeUp);
             } else {
                 //we need internal temperature all the time to control the fan
                 if(onTintern_) {
@@ -536,15 +670,43 @@ void AnalogInputs::finalizeDeltaMeasurement()
     }
 }
 
+void AnalogInputs::finalizeVirtual(Name name)
+{
+    STATIC_ASSERT(sizeOfArray(virtualGroup_) == LastInput - VirtualInputs - 1);
+    STATIC_ASSERT(sizeOfArray(groupMethod_) == VIRTUAL_GROUPS);
+
+    if(name <= VirtualInputs)
+        return;
+    uint8_t group = pgm::read(&virtualGroup_[name - VirtualInputs - 1]);
+    if(group == NoGroup || groupGeneration_[group] == calculationCount_)
+        return;
+    groupGeneration_[group] = calculationCount_;
+    callVoidMethod_P(&groupMethod_[group]);
+}
+
 void AnalogInputs::finalizeFullVirtualMeasurement()
 {
-    AnalogInputs::ValueType balancer = 0;
+    //inputs used by the stability checks (isOutStable, Balancer::isStable)
+    //and by the interrupt are computed every measurement,
+    //Pout, Cout and Eout only when someone reads them
+    finalizeVirtual(VoutBalancer);
+    finalizeVirtual(Iout);
+}
+
+void AnalogInputs::finalizeVout()
+{
     AnalogInputs::ValueType out_p = real_[Vout_plus_pin];
     AnalogInputs::ValueType out_m = real_[Vout_minus_pin];
     AnalogInputs::ValueType out = 0;
     if(out_m < out_p)
         out = out_p - out_m;
     setReal(Vout, out);
+}
+
+void AnalogInputs::finalizeBalancer()
+{
+    AnalogInputs::ValueType balancer = 0;
+    AnalogInputs::ValueType out = getRealValue(Vout);
 
 #ifdef ENABLE_SIMPLIFIED_VB0_VB2_CIRCUIT
     AnalogInputs::ValueType vb0_p = getRealValue(Vb0_pin);
@@ -572,7 +734,7 @@ void AnalogInputs::finalizeFullVirtualMeasurement()
 
     for(uint8_t i = 0; i < MAX_BALANCE_CELLS; i++) {
         if(connectedCells & (1<<i))
-            balancer += getRealValue(Name(Vb1+i));
+            balancer += real_[Vb1+i];
     }
 
     setReal(Vbalancer, balancer);
@@ -588,30 +750,65 @@ void AnalogInputs::finalizeFullVirtualMeasurement()
     setReal(VoutBalancer, out);
     setReal(VbalanceInfo, connectedCells);
     setReal(VobInfo, obInfo);
+}
 
+void AnalogInputs::finalizeIout()
+{
     AnalogInputs::ValueType IoutValue = 0;
     if(Discharger::isPowerOn()) {
         IoutValue = getRealValue(Idischarge);
     } else if (SMPS::isPowerOn()) {
         IoutValue = getRealValue(Ismps);
     }
+    setReal(Iout, IoutValue);
+}
 
-    uint32_t P = IoutValue;
-    P *= out;
+void AnalogInputs::finalizePout()
+{
+    uint32_t P = getRealValue(Iout);
+    P *= getRealValue(VoutBalancer);
     P /= 10000;
-    setReal(Pout, P);
+    setWideReal(Pout, P);
+}
 
-    setReal(Iout, IoutValue);
-    setReal(Cout, getCharge());
-    setReal(Eout, getEout());
+void AnalogInputs::finalizeAccumulated()
+{
+    setWideReal(Cout, getCharge());
+    setWideReal(Eout, getEout());
+}
+
+void AnalogInputs::setWideReal(Name name, WideValueType real)
+{
+    wideReal_[name - Pout] = real;
+    if(real > UINT16_MAX) real = UINT16_MAX;
+    setReal(name, real);
 }
 
 void AnalogInputs::setReal(Name name, ValueType real)
 {
-    if(absDiff(real_[name], real) > STABLE_VALUE_ERROR)
+    uint16_t noise = noise_[name];
+    ValueType error = absDiff(real_[name], real);
+    ValueType band = noise >> (ANALOG_INPUTS_NOISE_SHIFT - ANALOG_INPUTS_NOISE_BAND_SHIFT);
+    if(band < STABLE_MIN_ERROR)
+        band = STABLE_MIN_ERROR;
+
+    if(error > band) {
         stableCount_[name] = 0;
-    else
-        stableCount_[name]++;
+        //a step or a noisier input than learned - widen the band slowly
+        noise += (noise >> ANALOG_INPUTS_NOISE_SHIFT) + 1;
+    } else {
+        uint16_t count = stableCount_[name];
+        if(error > (band >> ANALOG_INPUTS_NOISE_BAND_SHIFT))
+            count |= ANALOG_INPUTS_STABLE_NOISY;
+        if((count & ANALOG_INPUTS_STABLE_COUNT_MAX) != ANALOG_INPUTS_STABLE_COUNT_MAX)
+            count++;
+        stableCount_[name] = count;
+        int16_t dn = (error << ANALOG_INPUTS_NOISE_SHIFT) - noise;
+        noise += dn >> ANALOG_INPUTS_NOISE_AVR_SHIFT;
+    }
+    if(noise > ANALOG_INPUTS_NOISE_MAX)
+        noise = ANALOG_INPUTS_NOISE_MAX;
+    noise_[name] = noise;
 
     real_[name] = real;
 }
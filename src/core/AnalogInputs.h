@@ -114,6 +114,9 @@ namespace AnalogInputs {
     ValueType getAvrADCValue(Name name);
     //get real value (usable) - average, after calibration
     ValueType getRealValue(Name name);
+    //get real value without 16-bit saturation (Pout, Cout, Eout)
+    WideValueType getWideRealValue(Name name);
+    bool isWide(Name name);
     //get the ADC (measured) value - in this particular moment
     ValueType getADCValue(Name name);
 
@@ -124,8 +127,8 @@ namespace AnalogInputs {
     ValueType getIout();
     ValueType getDeltaLastT();
     ValueType getDeltaCount();
-    ValueType getCharge();
-    ValueType getEout();
+    WideValueType getCharge();
+    WideValueType getEout();
     void enableDeltaVoutMax(bool enable);
 
     extern uint16_t connectedBalancePortCells;
@@ -145,6 +148,8 @@ namespace AnalogInputs {
     bool isPowerOn();
 
     void doFullMeasurement();
+    void setFastMeasurement(bool fast);
+    bool isFastMeasurement();
 
     void resetMeasurement();
     void resetAccumulatedMeasurements();
@@ -34,6 +34,8 @@
 
 namespace AnalogInputs {
     typedef uint16_t ValueType;
+    //accumulated values (charge, energy) and power don't fit into ValueType
+    typedef uint32_t WideValueType;
 
     enum Type {
         Current,
@@ -53,7 +55,11 @@ namespace AnalogInputs {
         Unknown
     };
 
+    //initial stable band, the band is then learned for every input from its noise
     static const ValueType  STABLE_VALUE_ERROR  = 6;
+    static const ValueType  STABLE_MIN_ERROR    = 2;
+    //largest learned band: 40mV, 40mA, 0.4C
+    static const ValueType  STABLE_MAX_ERROR    = 40;
     static const uint16_t   STABLE_MIN_VALUE    = 3;
 
     AnalogInputs::ValueType evalI(AnalogInputs::ValueType P, AnalogInputs::ValueType U);
@@ -0,0 +1,288 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#define __STDC_LIMIT_MACROS
+#include <string.h>
+#include "CycleHistory.h"
+#include "ProgramData.h"
+#include "ProgramDCcycle.h"
+#include "TheveninMethod.h"
+#include "Monitor.h"
+#include "memory.h"
+#include "Utils.h"
+
+#define CYCLE_HISTORY_FULL_RECORD ((uint8_t)0x80)
+
+namespace CycleHistory {
+
+    //delta resolution: 1 << shift
+    // Capacity: 4mAh, Energy: 0.04Wh, Time: 8s (CYCLE_HISTORY_TIME_UNIT), Resistance: 1mOhm, Temperature: 0.16C
+    const uint8_t deltaShift[] PROGMEM = { 2, 2, 0, 0, 4 };
+
+    uint8_t buffer_[CYCLE_HISTORY_SIZE];
+    uint8_t size_;
+    uint8_t firstCycle_;
+    uint8_t storedCycles_;
+    //last (decoded) records: discharge, charge
+    Record last_[2];
+    bool hasLast_[2];
+
+    //current charge/discharge
+    AnalogInputs::ValueType Tmax_;
+    uint32_t RthSum_;
+    uint16_t RthCount_;
+
+    Statistics statistics_[2];
+    //discharge capacity fade: sum(k*C), k - discharge number
+    int32_t fadeSumKC_;
+
+    void getCurrent(Record &r)
+    {
+        r.value[Capacity]   = AnalogInputs::getRealValue(AnalogInputs::Cout);
+        r.value[Energy]     = AnalogInputs::getRealValue(AnalogInputs::Eout);
+        uint32_t t = Monitor::getTotalChargeDischargeTimeSec();
+        t += CYCLE_HISTORY_TIME_UNIT/2;
+        t /= CYCLE_HISTORY_TIME_UNIT;
+        if(t > UINT16_MAX) t = UINT16_MAX;
+        r.value[Time]       = t;
+        r.value[Resistance] = RthCount_ ? RthSum_ / RthCount_ : 0;
+        r.value[Temperature]= Tmax_;
+    }
+
+    void resetCurrent()
+    {
+        Tmax_ = 0;
+        RthSum_ = 0;
+        RthCount_ = 0;
+    }
+
+    void writeFull(uint8_t *out, const Record &r)
+    {
+        *out++ = CYCLE_HISTORY_FULL_RECORD;
+        for(uint8_t f = 0; f < LAST_FIELD; f++) {
+            *out++ = r.value[f];
+            *out++ = r.value[f] >> 8;
+        }
+    }
+
+    //returns the number of bytes used by the record (0 - no space)
+    uint8_t encode(uint8_t *out, uint8_t space, const Record &r, Record &last, bool &hasLast)
+    {
+        int8_t d[LAST_FIELD];
+        bool delta = hasLast;
+        for(uint8_t f = 0; f < LAST_FIELD && delta; f++) {
+            uint8_t shift = pgm::read(&deltaShift[f]);
+            int32_t x = r.value[f];
+            x -= last.value[f];
+            //round to nearest
+            if(x < 0) x -= (1 << shift) / 2;
+            else      x += (1 << shift) / 2;
+            x /= (1 << shift);
+            if(x < -127 || x > 127)
+                delta = false;
+            d[f] = x;
+        }
+
+        if(delta) {
+            if(space < LAST_FIELD)
+                return 0;
+            for(uint8_t f = 0; f < LAST_FIELD; f++) {
+                out[f] = d[f];
+                last.value[f] += int16_t(d[f]) * (1 << pgm::read(&deltaShift[f]));
+            }
+            return LAST_FIELD;
+        }
+
+        if(space < 1 + 2*LAST_FIELD)
+            return 0;
+        writeFull(out, r);
+        last = r;
+        hasLast = true;
+        return 1 + 2*LAST_FIELD;
+    }
+
+    //returns the number of bytes read
+    uint8_t decode(const uint8_t *in, Record &last)
+    {
+        if(*in == CYCLE_HISTORY_FULL_RECORD) {
+            in++;
+            for(uint8_t f = 0; f < LAST_FIELD; f++) {
+                last.value[f] = in[0] | (uint16_t(in[1]) << 8);
+                in += 2;
+            }
+            return 1 + 2*LAST_FIELD;
+        }
+        for(uint8_t f = 0; f < LAST_FIELD; f++) {
+            last.value[f] += int16_t(int8_t(in[f])) * (1 << pgm::read(&deltaShift[f]));
+        }
+        return LAST_FIELD;
+    }
+
+    //drops the oldest (always full) record, the next record
+    //of the same type is rewritten as a full record
+    void dropOldest()
+    {
+        bool charge = isCharge(firstCycle_);
+        Record last[2];
+        uint8_t first = decode(buffer_, last[charge]);
+        uint8_t pos = first;
+        //cycles alternate: the next record is of the other type
+        if(storedCycles_ > 1)
+            pos += decode(&buffer_[pos], last[!charge]);
+        uint8_t keep = pos - first;
+
+        if(storedCycles_ > 2) {
+            uint8_t tail = pos + decode(&buffer_[pos], last[charge]);
+            memmove(buffer_, &buffer_[first], keep);
+            //first == full record size: the full record ends at "pos" <= "tail"
+            writeFull(&buffer_[keep], last[charge]);
+            memmove(&buffer_[pos], &buffer_[tail], size_ - tail);
+            size_ -= tail - pos;
+        } else {
+            memmove(buffer_, &buffer_[first], keep);
+            size_ = keep;
+            hasLast_[charge] = false;
+        }
+        firstCycle_++;
+        storedCycles_--;
+    }
+
+    void addStatistics(uint8_t cycle, const Record &r)
+    {
+        bool charge = isCharge(cycle);
+        Statistics &s = statistics_[charge];
+        AnalogInputs::ValueType C = r.value[Capacity];
+        if(s.count == 0 || C < s.min) s.min = C;
+        if(s.count == 0 || C > s.max) s.max = C;
+        if(!charge) {
+            int32_t kC = s.count;
+            kC *= C;
+            fadeSumKC_ += kC;
+        }
+        s.sum += C;
+        s.count++;
+    }
+
+} // namespace CycleHistory
+
+void CycleHistory::reset(uint8_t firstCycle)
+{
+    size_ = 0;
+    firstCycle_ = firstCycle;
+    storedCycles_ = 0;
+    hasLast_[0] = hasLast_[1] = false;
+    fadeSumKC_ = 0;
+    for(uint8_t i = 0; i < 2; i++) {
+        statistics_[i].count = 0;
+        statistics_[i].min = 0;
+        statistics_[i].max = 0;
+        statistics_[i].sum = 0;
+    }
+    resetCurrent();
+}
+
+void CycleHistory::update()
+{
+    AnalogInputs::Name name = AnalogInputs::Tintern;
+    if(ProgramData::battery.enable_externT)
+        name = AnalogInputs::Textern;
+    AnalogInputs::ValueType T = AnalogInputs::getRealValue(name);
+    if(T > Tmax_) Tmax_ = T;
+
+    if(TheveninMethod::isBattRthMeasured() && RthCount_ < UINT16_MAX) {
+        RthSum_ += TheveninMethod::getReadableBattRth();
+        RthCount_++;
+    }
+}
+
+void CycleHistory::store(uint8_t cycle)
+{
+    Record r;
+    getCurrent(r);
+    addStatistics(cycle, r);
+    resetCurrent();
+
+    //the oldest records are dropped when the buffer is full,
+    //the statistics are calculated for all cycles
+    if(cycle != firstCycle_ + storedCycles_)
+        return;
+    bool charge = isCharge(cycle);
+    uint8_t n;
+    while(!(n = encode(&buffer_[size_], CYCLE_HISTORY_SIZE - size_, r, last_[charge], hasLast_[charge]))
+            && storedCycles_ > 0) {
+        dropOldest();
+    }
+    if(n) {
+        size_ += n;
+        storedCycles_++;
+    }
+}
+
+bool CycleHistory::get(uint8_t cycle, Record &r)
+{
+    if(cycle < firstCycle_)
+        return false;
+    if(cycle == ProgramDCcycle::currentCycle) {
+        getCurrent(r);
+        return true;
+    }
+    uint8_t index = cycle - firstCycle_;
+    if(index >= storedCycles_)
+        return false;
+
+    Record last[2];
+    uint8_t pos = 0;
+    for(uint8_t i = firstCycle_; i <= cycle; i++) {
+        pos += decode(&buffer_[pos], last[isCharge(i)]);
+    }
+    r = last[isCharge(cycle)];
+    return true;
+}
+
+uint8_t CycleHistory::getFirstCycle()
+{
+    return firstCycle_;
+}
+
+const CycleHistory::Statistics & CycleHistory::getStatistics(bool charge)
+{
+    return statistics_[charge];
+}
+
+AnalogInputs::ValueType CycleHistory::getMean(bool charge)
+{
+    const Statistics &s = statistics_[charge];
+    if(s.count == 0)
+        return 0;
+    return s.sum / s.count;
+}
+
+//least squares slope of the discharge capacity:
+//  (sum(k*C) - (n-1)/2*sum(C)) * 12 / (n*(n^2-1))
+int16_t CycleHistory::getFadeSlope()
+{
+    const Statistics &s = statistics_[0];
+    int32_t n = s.count;
+    if(n < 2)
+        return 0;
+    int32_t num = fadeSumKC_;
+    num -= (n-1) * int32_t(s.sum) / 2;
+    num /= n;
+    num *= 120;
+    num /= n*n - 1;
+    return num;
+}
@@ -0,0 +1,67 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CYCLE_HISTORY_H_
+#define CYCLE_HISTORY_H_
+
+#include "AnalogInputs.h"
+
+//history buffer size in bytes, the first charge and discharge
+//are stored in full (11 bytes), next ones as deltas (5 bytes),
+//the oldest records are dropped when the buffer is full
+#ifndef CYCLE_HISTORY_SIZE
+#define CYCLE_HISTORY_SIZE 64
+#endif
+//Time field unit in seconds (up to ~145h)
+#define CYCLE_HISTORY_TIME_UNIT 8
+
+namespace CycleHistory {
+
+    enum Field { Capacity, Energy, Time, Resistance, Temperature, LAST_FIELD };
+
+    struct Record {
+        uint16_t value[LAST_FIELD];
+    };
+
+    struct Statistics {
+        uint8_t count;
+        AnalogInputs::ValueType min;
+        AnalogInputs::ValueType max;
+        uint32_t sum;
+    };
+
+    //cycle: ProgramDCcycle::currentCycle, odd - charge, even - discharge
+    inline bool isCharge(uint8_t cycle) { return cycle & 1; }
+
+    void reset(uint8_t firstCycle);
+    //called after every full measurement: max temperature, average Rth
+    void update();
+    //called at the end of a charge/discharge
+    void store(uint8_t cycle);
+
+    //returns false if "cycle" is not available (only the most recent cycles are kept)
+    bool get(uint8_t cycle, Record &r);
+    //the oldest cycle still stored
+    uint8_t getFirstCycle();
+
+    const Statistics & getStatistics(bool charge);
+    AnalogInputs::ValueType getMean(bool charge);
+    //discharge capacity fade, 0.1mAh per cycle
+    int16_t getFadeSlope();
+};
+
+#endif /* CYCLE_HISTORY_H_ */
@@ -26,6 +26,8 @@
 #define ENABLE_SERIAL_LOG
 #define ENABLE_TIME_LIMIT
 #define ENABLE_LCD_RAM_CG
+//LCD characters are sent from the timer interrupt
+#define ENABLE_LCD_QUEUE
 #define ENABLE_SCREEN_ANIMATION
 //#define ENABLE_SCREEN_KNIGHTRIDEREFFECT
 
@@ -37,13 +39,39 @@
 #define ENABLE_CALIBRATION_CHECK
 
 /*
- * (experimental and dangerous)
- * maximum charge current will be determined
- * dynamically based on power supply voltage
+ * charge power will be limited dynamically
+ * based on the converter efficiency map and
+ * the power supply voltage drop (see SMPS.cpp)
  */
-//#define ENABLE_DYNAMIC_MAX_POWER
+#define ENABLE_SMPS_INPUT_POWER_LIMIT
 
+/*
+ * interrupt and task durations reported in SerialLog channel 3
+ * (UART: "ext. deb"), uses ~100 bytes of RAM
+ */
+//#define ENABLE_PROFILER
+
+/*
+ * Strategy loop time, measurement -> strategy latency and control period
+ * histograms (debug screen, SerialLog channel 3), uses ~70 bytes of RAM
+ */
+//#define ENABLE_LOOP_STATS
+//histogram bucket boundaries in miliseconds (< 256)
+#define LOOP_STATS_BUCKETS_MS   2, 5, 10, 20, 50
+#define LOOP_STATS_BUCKETS      5
+
+/*
+ * strings with the common substrings replaced by tokens
+ * (see utils/stringsDictionary/generate.py),
+ * enabled in HardwareConfig.h of the targets with an almost full flash
+ */
+//#define ENABLE_STRINGS_DICTIONARY
+
+#ifdef ENABLE_STRINGS_DICTIONARY
+#define STRINGS_HEADER "strings/standard_dictionary.h"
+#else
 #define STRINGS_HEADER "strings/standard.h"
+#endif
 
 #define CHEALI_CHARGER_ARCHITECTURE                     (CHEALI_CHARGER_ARCHITECTURE_CPU + CHEALI_CHARGER_ARCHITECTURE_GENERIC)
 #define CHEALI_CHARGER_ARCHITECTURE_INFO                (MAX_BALANCE_CELLS)
@@ -34,7 +34,10 @@
 #include "Settings.h"
 #include "SerialLog.h"
 #include "DelayStrategy.h"
+#include "IRTestStrategy.h"
+#include "CapacityEstimateStrategy.h"
 #include "ProgramDCcycle.h"
+#include "ProgramSequence.h"
 #include "Calibration.h"
 
 namespace Program {
@@ -48,9 +51,10 @@ namespace Program {
     void setupTheveninCharge();
     void setupDischarge();
     void setupBalance();
+    void setupIRTest();
+    void setupCapacityEstimate();
     void setupDeltaCharge();
     void setupPowerSupplyCharge();
-    void setupProgramType(ProgramType prog);
 
     void dischargeOutputCapacitor();
 
@@ -103,6 +107,18 @@ void Program::setupBalance()
     Strategy::strategy = &Balancer::vtable;
 }
 
+void Program::setupIRTest()
+{
+    Strategy::setVI(ProgramData::VDischarged, false);
+    Strategy::strategy = &IRTestStrategy::vtable;
+}
+
+void Program::setupCapacityEstimate()
+{
+    Strategy::setVI(ProgramData::VDischarged, false);
+    Strategy::strategy = &CapacityEstimateStrategy::vtable;
+}
+
 void Program::setupProgramType(ProgramType prog) {
     Strategy::doBalance = false;
 
@@ -139,6 +155,12 @@ void Program::setupProgramType(ProgramType prog) {
         Strategy::doBalance = true;
         setupStorage();
         break;
+    case Program::CapacityEstimate:
+        setupCapacityEstimate();
+        break;
+    case Program::IRTest:
+        setupIRTest();
+        break;
     default:
         break;
     }
@@ -161,6 +183,8 @@ Strategy::statusType Program::runWithoutInfo(ProgramType prog)
             return ProgramDCcycle::runDCcycle(1, 3);
         case Program::DischargeChargeCycle:
             return ProgramDCcycle::runDCcycle(0, ProgramData::battery.DCcycles*2 - 1);
+        case Program::Sequence:
+            return ProgramSequence::run();
         default:
             return Strategy::doStrategy();
     }
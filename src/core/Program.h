@@ -26,6 +26,7 @@ namespace Program {
     enum ProgramType {
         Charge, ChargeBalance, Balance, Discharge, FastCharge,
         Storage, StorageBalance, DischargeChargeCycle, CapacityCheck,
+        CapacityEstimate, IRTest, Sequence,
         EditBattery,
         Calibrate,
         LAST_PROGRAM_TYPE};
@@ -41,6 +42,7 @@ namespace Program {
     void selectProgram(int index);
     void run(ProgramType prog);
 
+    void setupProgramType(ProgramType prog);
     Strategy::statusType runWithoutInfo(ProgramType prog);
     void resetAccumulatedMeasurements();
 
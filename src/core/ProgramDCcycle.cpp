@@ -21,7 +21,7 @@
 #include "DelayStrategy.h"
 #include "Settings.h"
 #include "Monitor.h"
-#include "ScreenCycle.h"
+#include "CycleHistory.h"
 
 using namespace Program;
 
@@ -42,12 +42,16 @@ Strategy::statusType ProgramDCcycle::runDCcycle(uint8_t firstCycle, uint8_t last
     Strategy::statusType status;
     Strategy::exitImmediately = true;
     currentCycle = firstCycle;
+    CycleHistory::reset(firstCycle);
     while(true) {
         if (currentCycle == lastCycle) {
             Strategy::exitImmediately = false;
         }
 
-        status = Program::runWithoutInfo(currentCycle & 1 ? Program::Charge : Program::Discharge);
+        status = Program::runWithoutInfo(CycleHistory::isCharge(currentCycle) ? Program::Charge : Program::Discharge);
+        if(status == Strategy::COMPLETE) {
+            CycleHistory::store(currentCycle);
+        }
         if(status != Strategy::COMPLETE || (!Strategy::exitImmediately)) break;
 
         currentCycle++;
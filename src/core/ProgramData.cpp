@@ -156,13 +156,6 @@ int16_t ProgramData::getDeltaVLimit()
 uint16_t ProgramData::getMaxIc()
 {
     AnalogInputs::ValueType v = getDefaultVoltage(VDischarged);
-#ifdef ENABLE_DYNAMIC_MAX_POWER
-    if(v > ANALOG_VOLT(8)) {
-        v -= ANALOG_VOLT(8);
-    } else {
-        v = 1;
-    }
-#endif
 
     AnalogInputs::ValueType i = AnalogInputs::evalI(settings.maxPc, v);
 
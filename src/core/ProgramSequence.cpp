@@ -0,0 +1,241 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "ProgramSequence.h"
+#include "Program.h"
+#include "ProgramData.h"
+#include "DelayStrategy.h"
+#include "StateOfCharge.h"
+#include "Time.h"
+#include "Utils.h"
+#include "memory.h"
+#include "eeprom.h"
+
+#define SEQUENCE_OP_SHIFT   5
+#define SEQUENCE_TIME_MASK  0x1f
+
+namespace ProgramSequence {
+    uint8_t currentStep;
+    //one loop counter per Repeat step - repeats can be nested
+    uint8_t loops_[SEQUENCE_MAX_STEPS];
+
+    //termination conditions of the current step
+    const Strategy::VTable * strategy_;
+    uint16_t startTime_;
+    uint16_t timeLimit_;
+    uint8_t endProcent_;
+    bool charge_;
+
+    void powerOn();
+    void powerOff();
+    Strategy::statusType doStrategy();
+
+    const Strategy::VTable vtable PROGMEM = {
+        powerOn,
+        powerOff,
+        doStrategy
+    };
+
+#define STEP(op, time, arg1, arg2) {((op) << SEQUENCE_OP_SHIFT) + (time), arg1, arg2}
+
+    const Code defaultSequence[] PROGMEM = {
+        STEP(Charge,    0, 0,  0),
+        STEP(Rest,      0, 10, 0),
+        STEP(Discharge, 0, 0,  0),
+        STEP(Rest,      0, 10, 0),
+        STEP(Storage,   0, 0,  0),
+    };
+
+    inline uint8_t getOp(const Code &c) {
+        uint8_t op = c.code >> SEQUENCE_OP_SHIFT;
+        if(op >= LAST_OPCODE) op = End;
+        return op;
+    }
+
+    Code readCode(uint8_t index) {
+        Code c;
+        c.code = End;
+        if(index < SEQUENCE_MAX_STEPS) {
+            eeprom::read(c, &eeprom::data.sequence[index]);
+        }
+        return c;
+    }
+
+    //evaluates the Repeat steps starting at "index" (they may follow
+    //each other or be jump targets), returns the next step to run
+    uint8_t resolveStep(uint8_t index, uint8_t *loops) {
+        Code c = readCode(index);
+        while(getOp(c) == Repeat) {
+            //arg1 - step number (1..index), only backward jumps
+            if(c.arg1 > 0 && c.arg1 <= index && loops[index] < c.arg2) {
+                loops[index]++;
+                index = c.arg1 - 1;
+            } else {
+                //an enclosing repeat runs this loop again
+                loops[index] = 0;
+                index++;
+            }
+            c = readCode(index);
+        }
+        return index;
+    }
+
+    void setCurrent(uint8_t rate, bool charge) {
+        uint32_t I = ProgramData::battery.capacity;
+        I *= rate;
+        I /= 10;
+        uint16_t maxI = charge ? ProgramData::getMaxIc() : ProgramData::getMaxId();
+        if(I > maxI) I = maxI;
+        Strategy::maxI = I;
+        if(Strategy::minI > Strategy::maxI) Strategy::minI = Strategy::maxI;
+    }
+
+    void setupStep(const Code &c) {
+        Program::ProgramType prog;
+        uint8_t op = getOp(c);
+
+        Program::resetAccumulatedMeasurements();
+
+        charge_ = false;
+        endProcent_ = 0;
+        timeLimit_ = (c.code & SEQUENCE_TIME_MASK) * SEQUENCE_TIME_UNIT * 60;
+
+        switch(op) {
+        case Rest:
+            DelayStrategy::setDelay(c.arg1);
+            Strategy::strategy = &DelayStrategy::vtable;
+            return;
+        case Charge:
+            charge_ = true;
+            prog = Program::Charge;
+            break;
+        case Discharge:
+            prog = Program::Discharge;
+            break;
+        case Storage:
+            prog = Program::Storage;
+            break;
+        case IRTest:
+            prog = Program::IRTest;
+            break;
+        default:
+            prog = Program::Balance;
+            break;
+        }
+
+        Program::programType = prog;
+        Program::setupProgramType(prog);
+        if(op == Charge || op == Discharge) {
+            endProcent_ = c.arg2;
+            if(c.arg1) {
+                setCurrent(c.arg1, charge_);
+            }
+        }
+    }
+
+} // namespace ProgramSequence
+
+void ProgramSequence::powerOn()
+{
+    startTime_ = Time::getSecondsU16();
+    callVoidMethod_P(&strategy_->powerOn);
+}
+
+void ProgramSequence::powerOff()
+{
+    callVoidMethod_P(&strategy_->powerOff);
+}
+
+Strategy::statusType ProgramSequence::doStrategy()
+{
+    if(timeLimit_ && Time::diffU16(startTime_, Time::getSecondsU16()) > timeLimit_) {
+        return Strategy::COMPLETE;
+    }
+    if(endProcent_) {
+        uint8_t procent = StateOfCharge::getProcent();
+        if(charge_ ? procent >= endProcent_ : procent <= endProcent_) {
+            return Strategy::COMPLETE;
+        }
+    }
+    Strategy::statusType (*doStrategy)() = pgm::read(&strategy_->doStrategy);
+    return doStrategy();
+}
+
+void ProgramSequence::loadStep(uint8_t index, Step &step)
+{
+    Code c = readCode(index);
+    step.op = getOp(c);
+    step.time = c.code & SEQUENCE_TIME_MASK;
+    step.arg1 = c.arg1;
+    step.arg2 = c.arg2;
+}
+
+void ProgramSequence::saveStep(uint8_t index, const Step &step)
+{
+    Code c;
+    c.code = (step.op << SEQUENCE_OP_SHIFT) + (step.time & SEQUENCE_TIME_MASK);
+    c.arg1 = step.arg1;
+    c.arg2 = step.arg2;
+    eeprom::write(&eeprom::data.sequence[index], c);
+    eeprom::restoreSequenceCRC();
+}
+
+void ProgramSequence::restoreDefault()
+{
+    Code c;
+    for(uint8_t i = 0; i < SEQUENCE_MAX_STEPS; i++) {
+        c.code = End;
+        c.arg1 = c.arg2 = 0;
+        if(i < sizeOfArray(defaultSequence)) {
+            pgm::read(c, &defaultSequence[i]);
+        }
+        eeprom::write(&eeprom::data.sequence[i], c);
+    }
+    eeprom::restoreSequenceCRC();
+}
+
+Strategy::statusType ProgramSequence::run()
+{
+    Strategy::statusType status = Strategy::COMPLETE;
+    Program::ProgramType programType = Program::programType;
+    Code c;
+
+    for(uint8_t i = 0; i < SEQUENCE_MAX_STEPS; i++)
+        loops_[i] = 0;
+    currentStep = resolveStep(0, loops_);
+    while(true) {
+        c = readCode(currentStep);
+        if(getOp(c) == End) break;
+
+        //look ahead on a copy of the loop counters
+        uint8_t loops[SEQUENCE_MAX_STEPS];
+        for(uint8_t i = 0; i < SEQUENCE_MAX_STEPS; i++)
+            loops[i] = loops_[i];
+        Strategy::exitImmediately = getOp(readCode(resolveStep(currentStep + 1, loops))) != End;
+
+        setupStep(c);
+        strategy_ = Strategy::strategy;
+        Strategy::strategy = &vtable;
+        status = Strategy::doStrategy();
+        Program::programType = programType;
+
+        if(status != Strategy::COMPLETE || !Strategy::exitImmediately) break;
+        currentStep = resolveStep(currentStep + 1, loops_);
+    }
+    return status;
+}
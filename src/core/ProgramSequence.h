@@ -0,0 +1,65 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PROGRAM_SEQUENCE_H_
+#define PROGRAM_SEQUENCE_H_
+
+#include "Strategy.h"
+#include "cpu.h"
+
+//the atmega32 eeprom is almost full: 9 steps * 3 bytes + CRC
+#define SEQUENCE_MAX_STEPS      9
+#define SEQUENCE_TIME_UNIT      10  //minutes
+
+namespace ProgramSequence {
+
+    enum OpCode { End, Charge, Discharge, Storage, Balance, Rest, Repeat, IRTest, LAST_OPCODE };
+
+    /*
+     * step in eeprom:
+     * code:    opcode (bits 7..5), time limit in SEQUENCE_TIME_UNIT (bits 4..0, 0 - no limit)
+     * arg1:    Charge, Discharge - current in 0.1C (0 - battery Ic, Id)
+     *          Rest - minutes
+     *          Repeat - step to jump to (1..Repeat step - 1, only backward)
+     * arg2:    Charge, Discharge - end state of charge in % (0 - battery end voltage)
+     *          Repeat - how many times
+     */
+    struct Code {
+        uint8_t code;
+        uint8_t arg1;
+        uint8_t arg2;
+    } CHEALI_EEPROM_PACKED;
+
+    //decoded step (editable by EditMenu)
+    struct Step {
+        uint16_t op;
+        uint16_t time;
+        uint16_t arg1;
+        uint16_t arg2;
+    };
+
+    extern uint8_t currentStep;
+
+    void loadStep(uint8_t index, Step &step);
+    void saveStep(uint8_t index, const Step &step);
+    void restoreDefault();
+
+    Strategy::statusType run();
+};
+
+
+#endif /* PROGRAM_SEQUENCE_H_ */
@@ -44,6 +44,26 @@ uint8_t countElements(const void * const array[])
 }
 
 
+bool updateVisibleIndex(VisibleIndex &index, uint32_t conditions, VisibleItemMethod isVisible)
+{
+    if(index.valid && index.conditions == conditions)
+        return false;
+
+    uint8_t size = 0;
+    for(uint8_t item = 0; size < index.capacity; item++) {
+        VisibleItem v = isVisible(item, conditions);
+        if(v == ItemLast)
+            break;
+        if(v == ItemVisible)
+            index.items[size++] = item;
+    }
+    index.size = size;
+    index.conditions = conditions;
+    index.valid = true;
+    return true;
+}
+
+
 bool testTintern(bool &more, AnalogInputs::ValueType off, AnalogInputs::ValueType on)
 {
     AnalogInputs::ValueType t = AnalogInputs::getRealValue(AnalogInputs::Tintern);
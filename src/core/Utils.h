@@ -69,6 +69,22 @@ uint8_t countElements(const void * const array[]);
 template<typename T>
 uint8_t countElements(const T array[]) {return countElements((const void * const *)array); }
 
+//visible items of a (PROGMEM) list, rebuilt only when the conditions change
+enum VisibleItem { ItemHidden, ItemVisible, ItemLast };
+typedef VisibleItem(*VisibleItemMethod)(uint8_t item, uint32_t conditions);
+
+struct VisibleIndex {
+    uint8_t * items;
+    uint8_t capacity;
+    uint8_t size;
+    bool valid;
+    uint32_t conditions;
+};
+
+inline void invalidateVisibleIndex(VisibleIndex &index) { index.valid = false; }
+//returns true if the index was rebuilt
+bool updateVisibleIndex(VisibleIndex &index, uint32_t conditions, VisibleItemMethod isVisible);
+
 // Platform specific delays. Implemented in Utils.cpp located in platform folder
 namespace Utils
 {
@@ -20,12 +20,20 @@
 #include "Buzzer.h"
 #include "memory.h"
 #include "Utils.h"
+#include "Scheduler.h"
+#include "atomic.h"
 //#define ENABLE_DEBUG
 #include "debug.h"
 
 //delay until next key read, must not be smaller than 7ms (see: atmeag32/generic/200W/AnalogInputsADC.cpp:adc_keyboard_)
 #define BUTTON_DELAY                 7
+#define BUTTON_DELAY_INTERRUPTS      (BUTTON_DELAY*1000/TIMER_INTERRUPT_PERIOD_MICROSECONDS)
 #define BUTTON_DEBOUNCE_COUNT        3
+//must be a power of 2
+#define BUTTON_QUEUE_SIZE            8
+//repeated keys waiting longer are dropped (main loop was busy)
+#define BUTTON_REPEAT_MAX_AGE        100
+#define BUTTON_REPEAT                0x80
 
 
 namespace Keyboard {
@@ -37,9 +45,20 @@ namespace Keyboard {
            //inState:                              175ms, 252ms, 504ms, 497ms, 994ms, for ever
            //changes/second (with speed factor):     5.7,  11.9,  47.6, 285.7,  1428,  4285
 
-    uint8_t last_key_ = BUTTON_NONE;
+    //key events, written by doInterrupt
+    struct Event {
+        uint8_t key;        //key | BUTTON_REPEAT
+        uint8_t state;
+        uint16_t time;      //Time::getMilisecondsU16()
+    };
+    Event queue_[BUTTON_QUEUE_SIZE];
+    volatile uint8_t queueHead_, queueTail_;
+
+    //interrupt state
+    uint8_t interval_ = BUTTON_DELAY_INTERRUPTS;
+    volatile uint8_t last_key_ = BUTTON_NONE;
     uint8_t debounce_ = 0;
-
+    uint8_t delay_ = 0;
     uint8_t inState_ = 0;
 
     //state_ - "key pressed" state
@@ -47,8 +66,11 @@ namespace Keyboard {
     //state_ == n - key is pressed and hold
     uint8_t state_ = 0;
 
+    //state of the last returned key
+    uint8_t eventState_ = 0;
+
     bool isLongPressTime() {
-        return state_ > 2;
+        return eventState_ > 2;
     }
 
     uint8_t getLast() {
@@ -56,49 +78,100 @@ namespace Keyboard {
     }
 
     uint8_t getSpeedFactor() {
-        return pgm::read(&speedFactor[state_]);
+        return pgm::read(&speedFactor[eventState_]);
+    }
+
+    void push(uint8_t key) {
+        uint8_t head = queueHead_;
+        uint8_t next = (head + 1) & (BUTTON_QUEUE_SIZE - 1);
+        if(next == queueTail_)
+            return;     //queue full - drop the key
+        queue_[head].key = key;
+        queue_[head].state = state_;
+        queue_[head].time = Time::getMilisecondsU16();
+        queueHead_ = next;
+    }
+
+    bool pop(Event &e) {
+        uint8_t tail = queueTail_;
+        if(tail == queueHead_)
+            return false;
+        ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+            e = queue_[tail];
+        }
+        queueTail_ = (tail + 1) & (BUTTON_QUEUE_SIZE - 1);
+        return true;
     }
 }
 
-uint8_t Keyboard::getPressedWithDelay()
+//debounce and auto-repeat, every BUTTON_DELAY
+void Keyboard::doInterrupt()
 {
-    uint8_t key, delay = 0, currentStateDelay;
-
-    pgm::read(currentStateDelay, &stateDelay[state_]);
+    if(--interval_)
+        return;
+    interval_ = BUTTON_DELAY_INTERRUPTS;
+
+    uint8_t key = hardware::getKeyPressed();
+    if(last_key_ != key) {
+        if(debounce_ == 0) {
+            //key changed
+            last_key_ = key;
+            state_ = 0;
+            inState_ = 0;
+            delay_ = 0;
+            push(key);
+            return;
+        }
+        debounce_--;
+    } else {
+        debounce_++;
+    }
+    if(debounce_ > BUTTON_DEBOUNCE_COUNT) {
+        debounce_ = BUTTON_DEBOUNCE_COUNT;
+        delay_++;
+    }
 
-    do {
-        Time::delayDoIdle(BUTTON_DELAY);
-        key = hardware::getKeyPressed();
-        if(last_key_ != key) {
-            if(debounce_ == 0) {
-                //key changed
-                last_key_ = key;
-                state_ = 0;
-                inState_ = 0;
-                if(key != BUTTON_NONE) {
-                    Buzzer::soundKeyboard();
+    if(delay_ > pgm::read(&stateDelay[state_])) {
+        delay_ = 0;
+        if(last_key_ != BUTTON_NONE) {
+            push(last_key_ | BUTTON_REPEAT);
+            //change state if necessary
+            if(state_ < sizeOfArray(stateDelay) - 1) {
+                inState_++;
+                if(inState_ >= pgm::read(&stayInState[state_])) {
+                    state_ ++;
+                    inState_ = 0;
                 }
-                return key;
             }
-            debounce_--;
-        } else {
-            debounce_++;
-        }
-        if(debounce_ > BUTTON_DEBOUNCE_COUNT) {
-            debounce_ = BUTTON_DEBOUNCE_COUNT;
-            delay++;
         }
-    } while (delay <= currentStateDelay);
+    }
+}
 
-    //change state if necessary
-    if(state_ < sizeOfArray(stateDelay) - 1 && key != BUTTON_NONE) {
-        inState_++;
-        if(inState_ >= pgm::read(&stayInState[state_])) {
-            state_ ++;
-            inState_ = 0;
+uint8_t Keyboard::getPressedWithDelay(bool wakeUp)
+{
+    //without keys return after the same time as the key repeat in state 0
+    const uint16_t timeout = (pgm::read(&stateDelay[0]) + 1) * BUTTON_DELAY;
+    uint16_t start = Time::getMilisecondsU16();
+    Event e;
+
+    do {
+        while(pop(e)) {
+            uint8_t key = e.key & ~BUTTON_REPEAT;
+            if(e.key & BUTTON_REPEAT) {
+                if(Time::diffU16(e.time, Time::getMilisecondsU16()) > BUTTON_REPEAT_MAX_AGE)
+                    continue;
+            } else if(key != BUTTON_NONE) {
+                Buzzer::soundKeyboard();
+            }
+            eventState_ = e.state;
+            return key;
         }
-    }
+        if(wakeUp && Scheduler::take(Scheduler::WakeUp)) {
+            return BUTTON_NONE;
+        }
+        Time::doIdle();
+    } while(Time::diffU16(start, Time::getMilisecondsU16()) < timeout);
 
-    return key;
+    eventState_ = 0;
+    return BUTTON_NONE;
 }
-
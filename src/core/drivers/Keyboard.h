@@ -30,8 +30,12 @@
 namespace Keyboard {
     uint8_t  getLast();
     uint8_t getSpeedFactor();
-    uint8_t  getPressedWithDelay();
+    //wakeUp - return BUTTON_NONE earlier on a new full measurement
+    uint8_t  getPressedWithDelay(bool wakeUp = false);
     bool isLongPressTime();
+
+    //private
+    void doInterrupt();
 };
 
 
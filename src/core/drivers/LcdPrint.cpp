@@ -15,31 +15,15 @@
     You should have received a copy of the GNU General Public License
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
+#define __STDC_LIMIT_MACROS
 #include "LcdPrint.h"
 #include "Hardware.h"
 #include "memory.h"
 #include "LiquidCrystal.h"
+#include "Dictionary.h"
 
 using namespace AnalogInputs;
 
-char* printLong(int32_t value, char * buf) {
-    char * end;
-    if (value < 0) {
-        *(buf++)='-';
-        value = -value;
-    }
-    buf += digits((int32_t)value);
-    *buf = 0;
-    end = buf;
-    buf--;
-    do {
-        *buf = (value%10) + '0';
-        value /= 10;
-        buf--;
-    } while(value);
-    return end;
-}
-
 void lcdSetCursor(uint8_t x, uint8_t y) { LiquidCrystal::setCursor(x, y); }
 void lcdSetCursor0_0() { lcdSetCursor(0,0); }
 void lcdSetCursor0_1() { lcdSetCursor(0,1); }
@@ -54,9 +38,9 @@ int8_t lcdPrintSpaces(int8_t n)
 
 void lcdPrintUInt(uint16_t x)
 {
-    char buf[11];
-    printLong(x, buf);
-    lcdPrint(buf, 11);
+    char buf[6];
+    printUInt32(x, buf);
+    lcdPrint(buf, 6);
 }
 
 void lcdPrintLong(int32_t x, int8_t dig)
@@ -102,7 +86,9 @@ int8_t lcdPrint_P(const char *str)
     int8_t n = 0;
     char c;
     if(str) {
-        while((c = pgm::read(str++)) != 0) {
+        Dictionary::Reader r;
+        Dictionary::begin(r, str);
+        while((c = Dictionary::read(r)) != 0) {
             lcdPrintChar(c);
             n++;
         }
@@ -112,61 +98,48 @@ int8_t lcdPrint_P(const char *str)
 
 void lcdPrintR_P(const char *str, int8_t size)
 {
-    uint8_t str_size = pgm::strlen(str);
+    uint8_t str_size = Dictionary::strlen(str);
     lcdPrintSpaces(size - str_size);
     lcdPrint_P(str);
 }
 
 
-static uint16_t div10(uint16_t div) {
-    if(div <= 100)
-        return 100;
-    return 1000;
-}
-
-void lcdPrintValue_(uint16_t x, int8_t dig, uint16_t div, bool mili, bool minus)
+void lcdPrintValue_(uint32_t x, int8_t dig, uint8_t decimals, bool mili, bool minus)
 {
-    char buf[12];
-    char *end, *dot_char;
-    int32_t t;
-
-    uint8_t size;
-
-    if(mili) {
-        t = x;
-        t *= 1000;
-        t /= div;
-        if(minus) {
-            t = -t;
+    //sign + 10 digits + 3 zeros ('m') or '.' + '\0'
+    char buf[15];
+    char *value = buf, *end;
+
+    if(minus) {
+        *(value++) = '-';
+    }
+
+    if(mili && x <= INT32_MAX/1000) {
+        //x * 1000 / 10^decimals
+        end = printUInt32(x, value);
+        if(x) {
+            for(uint8_t i = decimals; i < 3; i++) {
+                *(end++) = '0';
+            }
+            *end = 0;
         }
-        size = digits(t) + 1;
-        if(size <= dig) {
-            dig--;
-            lcdPrintLong(t, dig);
+        if(end - buf + 1 <= dig) {
+            lcdPrintR(buf, dig - 1);
             lcdPrintChar('m');
             return;
         }
     }
 
-    end = buf;
-
-    t = x / div;
-    if(minus) {
-        *(end++) = '-';
-    }
-    end = printLong(t, end);
-    if(div > 1 && end - buf < dig -1) {
-        dot_char = end;
-        t = x % div;
-        t += div;
-        t *= div10(div);
-        t /= div;
-        printLong(t, end);
+    end = printUInt32(x, value, decimals + 1);
+    char *dot_char = end - decimals;
+    if(decimals > 0 && dot_char - buf < dig - 1) {
+        memmove(dot_char + 1, dot_char, decimals + 1);
         *dot_char = '.';
+    } else {
+        *dot_char = 0;
     }
 
     lcdPrintR(buf, dig);
-
 }
 
 void lcdPrintTime(uint32_t timeSec, int8_t dig)
@@ -219,9 +192,10 @@ void lcdPrintDigit(uint8_t d)
 void lcdPrintUnsigned(uint16_t x, int8_t dig, const char prefix)
 {
 
-    uint8_t s = digits(x);
+    char buf[6];
+    int8_t s = printUInt32(x, buf) - buf;
     lcdPrintChar(prefix, dig - s);
-    lcdPrintUInt(x);
+    lcdPrint(buf, s);
 }
 
 void lcdPrintUnsigned(uint16_t x, int8_t dig)
@@ -269,48 +243,64 @@ void lcdPrint_mV(int16_t p, int8_t dig)
 }
 
 struct UnitsInfo {
-    uint16_t div;
+    uint8_t decimals;   //value = x / 10^decimals
     bool mili;
     const char * symbol;
 };
 static const UnitsInfo unitsInfo[] PROGMEM = {
         // Current
-        {ANALOG_AMP(1.000), true, string_A},
+        {3, true, string_A},
         //Voltage,
-        {ANALOG_VOLT(1.000), false, string_V},
+        {3, false, string_V},
         //Power,
-        {ANALOG_WATT(1.00), false,string_W},
+        {2, false,string_W},
         //Work,
-        {ANALOG_WATTH(1.00), false,string_Wh},
+        {2, false,string_Wh},
         //Temperature,
-        {ANALOG_CELCIUS(1.00), false, string_C},
+        {2, false, string_C},
         //Charge,
-        {ANALOG_CHARGE(1.000), true,string_Ah},
+        {3, true,string_Ah},
         //Resistance,
-        {ANALOG_OHM(1.000), true, string_Ohm},
+        {3, true, string_Ohm},
         //Procent,
-        {1, false, string_procent},
+        {0, false, string_procent},
         //SignedVoltage,
-        {ANALOG_VOLT(1.000), true, string_V},
+        {3, true, string_V},
         //Unsigned
-        {1, false, string_unsigned},
+        {0, false, string_unsigned},
         //TemperatureMinutes,
-        {ANALOG_CELCIUS(1.00), false, string_C_m},
+        {2, false, string_C_m},
         //Minutes
-        {1, false, AnalogInputs::string_minutes},
+        {0, false, AnalogInputs::string_minutes},
         //TimeLimitMinutes,
-        {1, false, AnalogInputs::string_minutes},
+        {0, false, AnalogInputs::string_minutes},
         //YesNo
-        {1, false, NULL},
+        {0, false, NULL},
         //Unknown
-        {1, false, AnalogInputs::string_unknown},
+        {0, false, AnalogInputs::string_unknown},
 };
 
 
-void lcdPrintAnalog(AnalogInputs::ValueType x, int8_t dig, AnalogInputs::Type type)
+static void lcdPrintAnalog_(uint32_t x, int8_t dig, AnalogInputs::Type type, bool sign)
 {
     STATIC_ASSERT(sizeOfArray(unitsInfo) -1 == AnalogInputs::Unknown);
+    STATIC_ASSERT(ANALOG_AMP(1.000) == 1000 && ANALOG_VOLT(1.000) == 1000 && ANALOG_CHARGE(1.000) == 1000);
+    STATIC_ASSERT(ANALOG_OHM(1.000) == 1000 && ANALOG_WATT(1.00) == 100 && ANALOG_WATTH(1.00) == 100);
+    STATIC_ASSERT(ANALOG_CELCIUS(1.00) == 100);
+
+    const char * symbol = pgm::read(&unitsInfo[type].symbol);
+    uint8_t symbol_size = Dictionary::strlen(symbol);
+
+    dig -= symbol_size;
+    if(dig <= 0)
+        return;
 
+    lcdPrintValue_(x, (int8_t) dig, pgm::read(&unitsInfo[type].decimals), pgm::read(&unitsInfo[type].mili), sign);
+    lcdPrint_P(symbol);
+}
+
+void lcdPrintAnalog(AnalogInputs::ValueType x, int8_t dig, AnalogInputs::Type type)
+{
     if(type == AnalogInputs::YesNo) {
         lcdPrintYesNo(x, dig);
     } else if(  (type == AnalogInputs::TimeLimitMinutes && x >= ANALOG_MAX_TIME_LIMIT)
@@ -319,13 +309,6 @@ void lcdPrintAnalog(AnalogInputs::ValueType x, int8_t dig, AnalogInputs::Type ty
             //TODO: programData::
             lcdPrint_P(string_unlimited);
     } else {
-        const char * symbol = pgm::read(&unitsInfo[type].symbol);
-        uint8_t symbol_size = pgm::strlen(symbol);
-
-        dig -= symbol_size;
-        if(dig <= 0)
-            return;
-
         bool sign = false;
         if(type == AnalogInputs::SignedVoltage || type == AnalogInputs::TemperatureMinutes) {
             int16_t y = x;
@@ -334,12 +317,15 @@ void lcdPrintAnalog(AnalogInputs::ValueType x, int8_t dig, AnalogInputs::Type ty
                 x = -y;
             }
         }
-
-        lcdPrintValue_(x, (int8_t) dig, pgm::read(&unitsInfo[type].div), pgm::read(&unitsInfo[type].mili), sign);
-        lcdPrint_P(symbol);
+        lcdPrintAnalog_(x, dig, type, sign);
     }
 }
 
+void lcdPrintAnalogWide(AnalogInputs::WideValueType x, int8_t dig, AnalogInputs::Type type)
+{
+    lcdPrintAnalog_(x, dig, type, false);
+}
+
 #ifdef ENABLE_LCD_RAM_CG
 void lcdCreateCGRam()
 {
@@ -22,8 +22,7 @@
 #include "Hardware.h"
 #include "AnalogInputs.h"
 #include "Utils.h"
-
-char* printLong(int32_t value, char * buf);
+#include "PrintNumber.h"
 
 #ifdef ENABLE_LCD_RAM_CG
 void lcdCreateCGRam();
@@ -64,6 +63,7 @@ void lcdPrintResistance(AnalogInputs::ValueType r, int8_t dig);
 void lcdPrintPercentage(AnalogInputs::ValueType p, int8_t dig);
 void lcdPrint_mV(int16_t p, int8_t dig);
 void lcdPrintAnalog(AnalogInputs::ValueType x, int8_t dig, AnalogInputs::Type type);
+void lcdPrintAnalogWide(AnalogInputs::WideValueType x, int8_t dig, AnalogInputs::Type type);
 
 void lcdPrintTime(uint32_t timeSec, int8_t dig);
 
@@ -28,6 +28,7 @@
 
 namespace LiquidCrystal {
     void send(uint8_t, uint8_t);
+    void sendNow(uint8_t, uint8_t);
     void write4bits(uint8_t);
     void write8bits(uint8_t);
     void pulseEnable();
@@ -39,8 +40,32 @@ namespace LiquidCrystal {
     uint8_t _initialized;
 
     uint8_t _numlines, _currline;
+
+    // shadow of the display RAM - only changed characters are sent
+    uint8_t _shadow[LCD_LINES][LCD_COLUMNS];
+    // cursor set by the user and the cursor of the display (LCD_CURSOR_UNKNOWN - must be set)
+    uint8_t _col, _row;
+    uint8_t _lcdCol, _lcdRow;
 }
 
+#define LCD_CURSOR_UNKNOWN 0xff
+
+#ifdef ENABLE_LCD_QUEUE
+// must be a power of 2
+#define LCD_QUEUE_SIZE      32
+// LCD_CLEARDISPLAY, LCD_RETURNHOME take 1.52ms (in timer interrupts)
+#define LCD_QUEUE_LONG_COMMAND_WAIT 4
+
+namespace LiquidCrystal {
+    // bytes (and RS) sent by doInterrupt, one every interrupt
+    uint8_t _queueValue[LCD_QUEUE_SIZE];
+    uint8_t _queueMode[LCD_QUEUE_SIZE];
+    volatile uint8_t _queueHead, _queueTail;
+    uint8_t _queueWait;
+    bool _queueOn;
+}
+#endif
+
 
 // When the display powers up, it is configured as follows:
 //
@@ -83,6 +108,10 @@ void LiquidCrystal::init()
 }
 
 void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
+#ifdef ENABLE_LCD_QUEUE
+  // initialization needs exact delays
+  _queueOn = false;
+#endif
   if (lines > 1) {
     _displayfunction |= LCD_2LINE;
   }
@@ -129,6 +158,7 @@ void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
 
     // finally, set to 4-bit interface
     write4bits(0x02);
+    Utils::delayMicroseconds(100);
 #else
     // this is according to the hitachi HD44780 datasheet
     // page 45 figure 23
@@ -153,36 +183,50 @@ void LiquidCrystal::begin(uint8_t cols, uint8_t lines, uint8_t dotsize) {
   display();
 
   // clear it off
-  clear();
+  command(LCD_CLEARDISPLAY);
+  Utils::delayMicroseconds(2000);  // this command takes a long time!
+  memset(_shadow, ' ', sizeof(_shadow));
+  _col = _row = _lcdCol = _lcdRow = 0;
 
   // Initialize to default text direction (for romance languages)
   _displaymode = LCD_ENTRYLEFT | LCD_ENTRYSHIFTDECREMENT;
   // set the entry mode
   command(LCD_ENTRYMODESET | _displaymode);
 
+#ifdef ENABLE_LCD_QUEUE
+  _queueOn = true;
+#endif
 }
 
 /********** high level commands, for the user! */
 void LiquidCrystal::clear()
 {
-  command(LCD_CLEARDISPLAY);  // clear display, set cursor position to zero
-  Utils::delayMicroseconds(2000);  // this command takes a long time!
+  // overwrite with spaces instead of LCD_CLEARDISPLAY (2ms),
+  // only not empty characters are sent
+  for(uint8_t row = 0; row < _numlines; row++) {
+    setCursor(0, row);
+    for(uint8_t col = 0; col < LCD_COLUMNS; col++) {
+      write(' ');
+    }
+  }
+  setCursor(0, 0);
 }
 
 void LiquidCrystal::home()
 {
   command(LCD_RETURNHOME);  // set cursor position to zero
   Utils::delayMicroseconds(2000);  // this command takes a long time!
+  _col = _row = _lcdCol = _lcdRow = 0;
 }
 
 void LiquidCrystal::setCursor(uint8_t col, uint8_t row)
 {
-  int row_offsets[] = { 0x00, 0x40, 0x14, 0x54 };
   if ( row >= _numlines ) {
     row = _numlines-1;    // we count rows starting w/0
   }
-
-  command(LCD_SETDDRAMADDR | (col + row_offsets[row]));
+  // the display cursor is moved when a changed character is written
+  _col = col;
+  _row = row;
 }
 
 // Turn the display on/off (quickly)
@@ -253,8 +297,9 @@ void LiquidCrystal::createChar(uint8_t location, uint8_t charmap[]) {
   location &= 0x7; // we only have 8 locations 0-7
   command(LCD_SETCGRAMADDR | (location << 3));
   for (int i=0; i<8; i++) {
-    write(charmap[i]);
+    send(charmap[i], HIGH);
   }
+  _lcdCol = LCD_CURSOR_UNKNOWN;
 }
 
 /*********** mid level commands, for sending data/cmds */
@@ -263,15 +308,63 @@ inline void LiquidCrystal::command(uint8_t value) {
   send(value, LOW);
 }
 
-inline uint8_t LiquidCrystal::write(uint8_t value) {
-  send(value, HIGH);
+uint8_t LiquidCrystal::write(uint8_t value) {
+  if(_col < LCD_COLUMNS && _row < LCD_LINES && _shadow[_row][_col] != value) {
+    if(_lcdCol != _col || _lcdRow != _row) {
+      static const uint8_t row_offsets[] = { 0x00, 0x40, 0x14, 0x54 };
+      command(LCD_SETDDRAMADDR | (_col + row_offsets[_row]));
+    }
+    send(value, HIGH);
+    _shadow[_row][_col] = value;
+    _lcdCol = _col + 1;
+    _lcdRow = _row;
+  }
+  _col++;
   return 1; // assume sucess
 }
 
 /************ low level data pushing commands **********/
 
-// write either command or data, with automatic 4/8-bit selection
 void LiquidCrystal::send(uint8_t value, uint8_t mode) {
+#ifdef ENABLE_LCD_QUEUE
+  if(_queueOn) {
+    uint8_t head = _queueHead;
+    uint8_t next = (head + 1) & (LCD_QUEUE_SIZE - 1);
+    // queue full - wait for the interrupt
+    while(next == _queueTail) {}
+    _queueValue[head] = value;
+    _queueMode[head] = mode;
+    _queueHead = next;
+    return;
+  }
+#endif
+  sendNow(value, mode);
+  Utils::delayMicroseconds(100);   // commands need > 37us to settle
+}
+
+#ifdef ENABLE_LCD_QUEUE
+// called every TIMER_INTERRUPT_PERIOD_MICROSECONDS - enough for a command to settle
+void LiquidCrystal::doInterrupt() {
+  if(_queueWait) {
+    _queueWait--;
+    return;
+  }
+  uint8_t tail = _queueTail;
+  if(tail == _queueHead)
+    return;
+
+  uint8_t value = _queueValue[tail];
+  uint8_t mode = _queueMode[tail];
+  sendNow(value, mode);
+  if(mode == LOW && value <= LCD_RETURNHOME) {
+    _queueWait = LCD_QUEUE_LONG_COMMAND_WAIT;
+  }
+  _queueTail = (tail + 1) & (LCD_QUEUE_SIZE - 1);
+}
+#endif
+
+// write either command or data, with automatic 4/8-bit selection
+void LiquidCrystal::sendNow(uint8_t value, uint8_t mode) {
   IO::digitalWrite(LCD_RS_PIN, mode);
 
   // if there is a RW pin indicated, set it low to Write
@@ -293,7 +386,7 @@ void LiquidCrystal::pulseEnable(void) {
   IO::digitalWrite(LCD_ENABLE_PIN, HIGH);
   Utils::delayMicroseconds(1);    // enable pulse must be >450ns
   IO::digitalWrite(LCD_ENABLE_PIN, LOW);
-  Utils::delayMicroseconds(100);   // commands need > 37us to settle
+  Utils::delayMicroseconds(1);
 }
 
 void LiquidCrystal::write4bits(uint8_t value) {
@@ -97,6 +97,9 @@ namespace LiquidCrystal {
   uint8_t print(char c);
   uint8_t print(const char buffer[]);
 
+  //private
+  void doInterrupt();
+
 } //namespace LiquidCrystal
 
 #endif
@@ -0,0 +1,143 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#define __STDC_LIMIT_MACROS
+#include "LoopStats.h"
+#include "Time.h"
+#include "memory.h"
+#include "atomic.h"
+#include "Utils.h"
+#include <string.h>
+
+#ifdef ENABLE_LOOP_STATS
+
+namespace LoopStats {
+    const uint8_t boundaries[] PROGMEM = { LOOP_STATS_BUCKETS_MS };
+
+    Stats stats[LAST_HISTOGRAM];
+
+    uint16_t lastLoop_;
+    uint16_t lastRun_;
+    volatile uint16_t adcDoneTime_;
+    uint16_t measurementTime_;
+    bool loopStarted_;
+    bool runStarted_;
+    bool measurementValid_;
+
+    void add(Histogram h, uint16_t ms) {
+        Stats &s = stats[h];
+        if(s.count == UINT16_MAX) {
+            //halve the weights, the shape of the histogram stays
+            s.count >>= 1;
+            s.sum >>= 1;
+            for(uint8_t i = 0; i < LOOP_STATS_HISTOGRAM; i++) {
+                s.histogram[i] >>= 1;
+            }
+        }
+        s.count++;
+        s.sum += ms;
+        if(ms < s.min) s.min = ms;
+        if(ms > s.max) s.max = ms;
+
+        uint8_t bucket = 0;
+        while(bucket < LOOP_STATS_BUCKETS && ms >= getBoundary(bucket)) {
+            bucket++;
+        }
+        s.histogram[bucket]++;
+    }
+}
+
+void LoopStats::reset()
+{
+    STATIC_ASSERT(sizeOfArray(boundaries) == LOOP_STATS_BUCKETS);
+
+    memset(stats, 0, sizeof(stats));
+    for(uint8_t i = 0; i < LAST_HISTOGRAM; i++) {
+        stats[i].min = UINT16_MAX;
+    }
+    loopStarted_ = false;
+    runStarted_ = false;
+    measurementValid_ = false;
+}
+
+void LoopStats::loop()
+{
+    uint16_t t = Time::getMilisecondsU16();
+    if(loopStarted_) {
+        add(LoopTime, Time::diffU16(lastLoop_, t));
+    }
+    lastLoop_ = t;
+    loopStarted_ = true;
+}
+
+void LoopStats::adcDone()
+{
+    adcDoneTime_ = Time::getMilisecondsU16();
+}
+
+void LoopStats::newMeasurement()
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        measurementTime_ = adcDoneTime_;
+    }
+    measurementValid_ = true;
+}
+
+void LoopStats::strategyRun()
+{
+    uint16_t t = Time::getMilisecondsU16();
+    if(measurementValid_) {
+        add(Latency, Time::diffU16(measurementTime_, t));
+        measurementValid_ = false;
+    }
+    if(runStarted_) {
+        add(ControlPeriod, Time::diffU16(lastRun_, t));
+    }
+    lastRun_ = t;
+    runStarted_ = true;
+}
+
+uint8_t LoopStats::getBoundary(uint8_t bucket)
+{
+    return pgm::read(&boundaries[bucket]);
+}
+
+uint16_t LoopStats::getMean(Histogram h)
+{
+    if(stats[h].count == 0)
+        return 0;
+    return stats[h].sum / stats[h].count;
+}
+
+uint8_t LoopStats::getShare(Histogram h, uint8_t bucket)
+{
+    if(stats[h].count == 0)
+        return 0;
+    uint32_t share = stats[h].histogram[bucket];
+    share = share * 10 / stats[h].count;
+    if(share > 9) share = 9;
+    return share;
+}
+
+uint16_t LoopStats::getJitter()
+{
+    if(stats[ControlPeriod].count == 0)
+        return 0;
+    return stats[ControlPeriod].max - stats[ControlPeriod].min;
+}
+
+#endif //ENABLE_LOOP_STATS
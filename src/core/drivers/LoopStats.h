@@ -0,0 +1,69 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef LOOPSTATS_H_
+#define LOOPSTATS_H_
+
+#include "Hardware.h"
+
+#ifdef ENABLE_LOOP_STATS
+
+#define LOOP_STATS_HISTOGRAM    (LOOP_STATS_BUCKETS + 1)
+
+/*
+ * Strategy::doStrategy loop timing (miliseconds),
+ * histogram buckets: < LOOP_STATS_BUCKETS_MS[0], < LOOP_STATS_BUCKETS_MS[1], ..., rest
+ */
+namespace LoopStats {
+    enum Histogram {
+        LoopTime,       //one loop iteration
+        Latency,        //ADC round done -> strategy ran on the new measurement
+        ControlPeriod,  //between two strategy runs
+        LAST_HISTOGRAM
+    };
+
+    struct Stats {
+        uint16_t count;
+        uint16_t min;
+        uint16_t max;
+        uint32_t sum;
+        uint16_t histogram[LOOP_STATS_HISTOGRAM];
+    };
+
+    extern Stats stats[LAST_HISTOGRAM];
+
+    void reset();
+    //at the beginning of each loop iteration
+    void loop();
+    //interrupt: ADC round finished
+    void adcDone();
+    //full measurement calculated from the last ADC round
+    void newMeasurement();
+    //strategy ran on the new measurement
+    void strategyRun();
+
+    uint8_t getBoundary(uint8_t bucket);
+    uint16_t getMean(Histogram h);
+    //in 1/10, 0..9
+    uint8_t getShare(Histogram h, uint8_t bucket);
+    //control period: max - min
+    uint16_t getJitter();
+};
+
+#endif //ENABLE_LOOP_STATS
+
+#endif /* LOOPSTATS_H_ */
@@ -0,0 +1,59 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "PrintNumber.h"
+#include "memory.h"
+#include "Utils.h"
+
+namespace {
+    const uint32_t pow10_[] PROGMEM = {
+        1000000000, 100000000, 10000000, 1000000, 100000, 10000, 1000, 100, 10
+    };
+}
+
+char* printUInt32(uint32_t value, char * buf, uint8_t minDigits)
+{
+    bool print = false;
+    for(uint8_t i = 0; i < sizeOfArray(pow10_); i++) {
+        //each digit: at most 9 subtractions of the power of 10
+        uint32_t p = pgm::read(&pow10_[i]);
+        char c = '0';
+        while(value >= p) {
+            value -= p;
+            c++;
+        }
+        if(c != '0' || minDigits > sizeOfArray(pow10_) - i) {
+            print = true;
+        }
+        if(print) {
+            *(buf++) = c;
+        }
+    }
+    *(buf++) = '0' + value;
+    *buf = 0;
+    return buf;
+}
+
+char* printLong(int32_t value, char * buf)
+{
+    uint32_t v = value;
+    if (value < 0) {
+        *(buf++)='-';
+        v = -value;
+    }
+    return printUInt32(v, buf);
+}
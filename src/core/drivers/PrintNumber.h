@@ -0,0 +1,33 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PRINTNUMBER_H_
+#define PRINTNUMBER_H_
+
+#include <stdint.h>
+
+/*
+ * number to decimal string conversion without divisions
+ * (the atmega32 has no hardware divider),
+ * used by LcdPrint, cprintf and SerialLog
+ */
+
+//prints at least minDigits digits (with leading zeros), returns the end of the string
+char* printUInt32(uint32_t value, char * buf, uint8_t minDigits = 1);
+char* printLong(int32_t value, char * buf);
+
+#endif /* PRINTNUMBER_H_ */
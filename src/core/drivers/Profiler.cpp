@@ -0,0 +1,56 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#define __STDC_LIMIT_MACROS
+#include "Profiler.h"
+#include "atomic.h"
+#include <string.h>
+
+#ifdef ENABLE_PROFILER
+
+namespace Profiler {
+    Stats stats_[LAST_PROBE];
+}
+
+void Profiler::add(Probe probe, uint16_t ticks)
+{
+    Stats &s = stats_[probe];
+    if(s.count == UINT16_MAX)
+        return;
+
+    s.count++;
+    s.sum += ticks;
+    if(ticks > s.max) s.max = ticks;
+
+    uint8_t bucket = 0;
+    ticks /= PROFILER_FIRST_BUCKET;
+    while(ticks && bucket < PROFILER_BUCKETS - 1) {
+        ticks >>= PROFILER_BUCKET_SHIFT;
+        bucket++;
+    }
+    s.histogram[bucket]++;
+}
+
+void Profiler::take(Probe probe, Stats &stats)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        stats = stats_[probe];
+        memset(&stats_[probe], 0, sizeof(Stats));
+    }
+}
+
+#endif //ENABLE_PROFILER
@@ -0,0 +1,65 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+#include "Hardware.h"
+#include "Time.h"
+
+#define PROFILER_BUCKETS        4
+//bucket i: duration < PROFILER_FIRST_BUCKET << (i * PROFILER_BUCKET_SHIFT) ticks
+#define PROFILER_FIRST_BUCKET   16
+#define PROFILER_BUCKET_SHIFT   3
+
+#ifdef ENABLE_PROFILER
+
+namespace Profiler {
+    enum Probe {
+        AdcInterrupt,
+        TimeInterrupt,
+        SmpsPid,
+        FullMeasurement,
+        DisplayPage,
+        DoStrategy,
+        LAST_PROBE
+    };
+
+    struct Stats {
+        uint16_t count;
+        uint16_t max;       //ticks
+        uint32_t sum;       //ticks
+        uint16_t histogram[PROFILER_BUCKETS];
+    };
+
+    //can be called from interrupts
+    void add(Probe probe, uint16_t ticks);
+    //copies and resets the statistics
+    void take(Probe probe, Stats &stats);
+};
+
+#define PROFILER_BEGIN(start)       uint16_t start = Time::getTicksU16()
+#define PROFILER_END(probe, start)  Profiler::add(Profiler::probe, Time::getTicksU16() - start)
+
+#else
+
+#define PROFILER_BEGIN(start)
+#define PROFILER_END(probe, start)
+
+#endif //ENABLE_PROFILER
+
+#endif /* PROFILER_H_ */
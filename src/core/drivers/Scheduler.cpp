@@ -0,0 +1,83 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Scheduler.h"
+#include "Time.h"
+#include "Monitor.h"
+#include "Buzzer.h"
+#include "SerialLog.h"
+#include "AnalogInputsPrivate.h"
+#include "memory.h"
+#include "atomic.h"
+#include "Utils.h"
+
+//in timer interrupts
+#define SCHEDULER_BUZZER_PERIOD     1
+#define SCHEDULER_MONITOR_PERIOD    200
+
+namespace Scheduler {
+    struct Task {
+        VoidMethod method;
+        uint8_t events;
+        uint8_t period;     //0 - run only on events
+    };
+
+    //in priority order
+    const Task tasks[] PROGMEM = {
+        {AnalogInputs::doIdle,  AdcDone,        0},
+        {Buzzer::doIdle,        0,              SCHEDULER_BUZZER_PERIOD},
+        {SerialLog::doIdle,     Measurement,    0},
+        {Monitor::doIdle,       0,              SCHEDULER_MONITOR_PERIOD},
+    };
+
+    volatile uint8_t events_;
+    uint16_t lastRun_[sizeOfArray(tasks)];
+}
+
+void Scheduler::post(uint8_t events)
+{
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        events_ |= events;
+    }
+}
+
+bool Scheduler::take(uint8_t events)
+{
+    uint8_t pending;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        pending = events_ & events;
+        events_ &= ~events;
+    }
+    return pending != 0;
+}
+
+void Scheduler::run()
+{
+    uint16_t now = Time::getInterruptsU16();
+    for(uint8_t i = 0; i < sizeOfArray(tasks); i++) {
+        uint8_t events = pgm::read(&tasks[i].events);
+        uint8_t period = pgm::read(&tasks[i].period);
+        bool ready = (events && take(events))
+                || (period && Time::diffU16(lastRun_[i], now) >= period);
+        if(ready) {
+            lastRun_[i] = now;
+            callVoidMethod_P(&tasks[i].method);
+            //run to completion, higher priority tasks are checked first again
+            return;
+        }
+    }
+}
@@ -0,0 +1,39 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+#include <stdint.h>
+
+namespace Scheduler {
+    enum Event {
+        AdcDone     = 1,    //ADC round finished (interrupt)
+        Measurement = 2,    //new full measurement
+        WakeUp      = 4,    //new full measurement - ends Keyboard::getPressedWithDelay(true)
+    };
+
+    //can be called from interrupts
+    void post(uint8_t events);
+    //returns true if any of the events was pending and clears them
+    bool take(uint8_t events);
+
+    //runs the highest priority task which has a pending event or is due
+    void run();
+};
+
+#endif /* SCHEDULER_H_ */
@@ -17,11 +17,16 @@
 */
 #include "Hardware.h"
 #include "LcdPrint.h"
+#include "PrintNumber.h"
+#include "Dictionary.h"
+#include "Profiler.h"
+#include "LoopStats.h"
 #include "Program.h"
 #include "Settings.h"
 #include "memory.h"
 #include "Version.h"
 #include "TheveninMethod.h"
+#include "IRTestStrategy.h"
 #include "StackInfo.h"
 #include "IO.h"
 #include "SerialLog.h"
@@ -136,17 +141,11 @@ void flush()
 }
 
 
+//called by the scheduler on every new full measurement
 void doIdle()
 {
-    static uint16_t analogCount;
-    if(!AnalogInputs::isPowerOn()) {
-        analogCount = 0;
-    } else {
-        uint16_t c = AnalogInputs::getFullMeasurementCount();
-        if(analogCount != c) {
-            analogCount = c;
-            send();
-        }
+    if(AnalogInputs::isPowerOn()) {
+        send();
     }
     LogDebug_run();
 }
@@ -183,13 +182,14 @@ void printString(const char *s)
 void printString_P(const char *s)
 {
     char c;
+    Dictionary::Reader r;
+    Dictionary::begin(r, s);
     while(1) {
-        c = pgm::read(s);
+        c = Dictionary::read(r);
         if(!c)
             return;
 
         printChar(c);
-        s++;
     }
 }
 
@@ -239,22 +239,31 @@ void sendChannel1()
     //analog inputs
     for(uint8_t i=0;i < sizeOfArray(channel1);i++) {
         AnalogInputs::Name name = pgm::read(&channel1[i]);
-        uint16_t v = AnalogInputs::getRealValue(name);
-        printUInt(v);
+        //Cout, Pout, Eout may exceed 16 bits
+        printLong(AnalogInputs::getWideRealValue(name));
         printD();
     }
 
-    for(uint8_t i=0;i<MAX_BALANCE_CELLS;i++) {
-        printUInt(TheveninMethod::getReadableRthCell(i));
+    if(Program::programType == Program::IRTest) {
+        for(uint8_t i=0;i<MAX_BALANCE_CELLS;i++) {
+            printUInt(IRTestStrategy::getReadableRthCell(i));
+            printD();
+        }
+        printUInt(IRTestStrategy::getReadableBattRth());
+        printD();
+        printUInt(IRTestStrategy::getReadableWiresRth());
+        printD();
+    } else {
+        for(uint8_t i=0;i<MAX_BALANCE_CELLS;i++) {
+            printUInt(TheveninMethod::getReadableRthCell(i));
+            printD();
+        }
+        printUInt(TheveninMethod::getReadableBattRth());
+        printD();
+        printUInt(TheveninMethod::getReadableWiresRth());
         printD();
     }
 
-    printUInt(TheveninMethod::getReadableBattRth());
-    printD();
-
-    printUInt(TheveninMethod::getReadableWiresRth());
-    printD();
-
     printUInt(Monitor::getChargeProcent());
     printD();
     printLong(Monitor::getETATime());
@@ -282,6 +291,14 @@ void sendChannel2(bool adc)
 #endif
     printUInt(pidV);
     printD();
+
+    //pack imbalance model
+    for(uint8_t i=0;i<MAX_BALANCE_CELLS;i++) {
+        printUInt(Balancer::getExcessCharge(i));
+        printD();
+    }
+    printUInt(Balancer::getBalanceTimeEstimate());
+    printD();
     sendEnd();
 }
 
@@ -293,6 +310,47 @@ void sendChannel3()
     printD();
     printUInt(StackInfo::getFreeStackSize());
     printD();
+#endif
+#ifdef ENABLE_PROFILER
+    //per probe: count, max cycles, mean cycles, histogram
+    for(uint8_t i = 0; i < Profiler::LAST_PROBE; i++) {
+        Profiler::Stats s;
+        Profiler::take(Profiler::Probe(i), s);
+        printUInt(s.count);
+        printD();
+        printLong((uint32_t) s.max * TIME_TICK_CYCLES);
+        printD();
+        uint32_t mean = 0;
+        if(s.count) mean = s.sum * TIME_TICK_CYCLES / s.count;
+        printLong(mean);
+        printD();
+        for(uint8_t j = 0; j < PROFILER_BUCKETS; j++) {
+            printUInt(s.histogram[j]);
+            printD();
+        }
+    }
+#endif
+#ifdef ENABLE_LOOP_STATS
+    //bucket boundaries, then per histogram: count, min, max, mean [ms], buckets
+    for(uint8_t i = 0; i < LOOP_STATS_BUCKETS; i++) {
+        printUInt(LoopStats::getBoundary(i));
+        printD();
+    }
+    for(uint8_t i = 0; i < LoopStats::LAST_HISTOGRAM; i++) {
+        LoopStats::Stats &s = LoopStats::stats[i];
+        printUInt(s.count);
+        printD();
+        printUInt(s.count ? s.min : 0);
+        printD();
+        printUInt(s.max);
+        printD();
+        printUInt(LoopStats::getMean(LoopStats::Histogram(i)));
+        printD();
+        for(uint8_t j = 0; j < LOOP_STATS_HISTOGRAM; j++) {
+            printUInt(s.histogram[j]);
+            printD();
+        }
+    }
 #endif
     sendEnd();
 }
@@ -18,9 +18,10 @@
 #include "Time.h"
 #include "Hardware.h"
 #include "Monitor.h"
-#include "Buzzer.h"
-#include "Screen.h"
-#include "SerialLog.h"
+#include "Balancer.h"
+#include "Scheduler.h"
+#include "Keyboard.h"
+#include "LiquidCrystal.h"
 #include "AnalogInputsPrivate.h"
 #include "atomic.h"
 
@@ -45,15 +46,18 @@ namespace Time {
     }
 
     void doIdle() {
-        Monitor::doIdle();
-        SerialLog::doIdle();
-        Buzzer::doIdle();
-        AnalogInputs::doIdle();
+        Scheduler::run();
     }
 
     void callback() {
         static uint8_t slowInterval = TIMER_SLOW_INTERRUPT_INTERVAL;
         Time::doInterrupt();
+        Balancer::doInterrupt();
+        Monitor::doInterrupt();
+        Keyboard::doInterrupt();
+#ifdef ENABLE_LCD_QUEUE
+        LiquidCrystal::doInterrupt();
+#endif
         if(--slowInterval == 0){
             slowInterval = TIMER_SLOW_INTERRUPT_INTERVAL;
             AnalogInputs::doSlowInterrupt();
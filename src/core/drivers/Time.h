@@ -23,6 +23,8 @@
 #define TIMER_INTERRUPT_PERIOD_MICROSECONDS     500
 #define TIMER_SLOW_INTERRUPT_INTERVAL           225
 #define SLOW_INTERRUPT_PERIOD_MILISECONDS ((long)TIMER_INTERRUPT_PERIOD_MICROSECONDS*TIMER_SLOW_INTERRUPT_INTERVAL/1000)
+//cpu cycles per Time::getTicksU16() tick
+#define TIME_TICK_CYCLES                        64
 
 namespace Time {
     void initialize();
@@ -34,6 +36,10 @@ namespace Time {
     uint32_t getSeconds();
     uint16_t getMinutesU16();
     void delay(uint16_t ms);
+    //free-running counter (cpu specific, used by the Profiler)
+    uint16_t getTicksU16();
+    //runs the scheduled idle tasks once
+    void doIdle();
 
     //warning: this method runs stuff in background,
     //delay may take significantly longer than "ms"
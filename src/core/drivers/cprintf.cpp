@@ -20,6 +20,7 @@
 #include "cprintf.h"
 #include "memory.h"
 #include "LcdPrint.h"
+#include "Dictionary.h"
 #include "ProgramData.h"
 
 namespace cprintf {
@@ -43,16 +44,19 @@ void cprintf(const PrintData * printDataPtr, uint8_t dig)
             case CP_TYPE_UINT32_ARRAY:
                 pgm::read(array, p.data.arrayPtr);
                 v = pgm::read(&array.ArrayPtr.uint32Ptr[*array.indexPtr]);
-                v/=100;
-                lcdPrintUnsigned(v, dig-2);
-                lcdPrintChar('0');
-                lcdPrintChar('0');
+                {
+                    //rounded down to hundreds
+                    char buf[11];
+                    char * end = printUInt32(v, buf, 3);
+                    end[-1] = end[-2] = '0';
+                    lcdPrintR(buf, dig);
+                }
                 break;
 
             case CP_TYPE_STRING_ARRAY:
                 pgm::read(array, p.data.arrayPtr);
                 strPtr = pgm::read(&array.ArrayPtr.stringArrayPtr[*array.indexPtr]);
-                i = pgm::strlen(strPtr);
+                i = Dictionary::strlen(strPtr);
                 lcdPrintSpaces(dig-i);
                 lcdPrint_P(array.ArrayPtr.stringArrayPtr, *array.indexPtr);
                 break;
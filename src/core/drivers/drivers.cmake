@@ -1,7 +1,7 @@
 
 set(CORE_SOURCE
-    cprintf.cpp  Blink.cpp  Buzzer.cpp  Keyboard.h     LcdPrint.h    LiquidCrystal.h    PolarityCheck.h    SerialLog.h      Time.cpp
-    cprintf.h    Blink.h    Buzzer.h    Keyboard.cpp   LcdPrint.cpp  LiquidCrystal.cpp  PolarityCheck.cpp  SerialLog.cpp    StackInfo.h  Time.h
+    cprintf.cpp  Blink.cpp  Buzzer.cpp  Keyboard.h     LcdPrint.h    LiquidCrystal.h    PolarityCheck.h    SerialLog.h      Time.cpp  Scheduler.cpp  PrintNumber.cpp  Profiler.cpp  LoopStats.cpp
+    cprintf.h    Blink.h    Buzzer.h    Keyboard.cpp   LcdPrint.cpp  LiquidCrystal.cpp  PolarityCheck.cpp  SerialLog.cpp    StackInfo.h  Time.h    Scheduler.h    PrintNumber.h    Profiler.h    LoopStats.h
 )
 
 CHEALI_ADD("CORE_SOURCE_FILES" "${CORE_SOURCE}")
@@ -20,6 +20,7 @@
 #include "ProgramData.h"
 #include "Hardware.h"
 #include "Settings.h"
+#include "ProgramSequence.h"
 #include "memory.h"
 #include "Version.h"
 #include "eeprom.h"
@@ -60,8 +61,12 @@ namespace eeprom {
         if(restore & EEPROM_RESTORE_CALIBRATION) AnalogInputs::restoreDefault();
         if(restoreCalibrationCRC(false)) test |= EEPROM_RESTORE_CALIBRATION;
 
-        if(restore & EEPROM_RESTORE_PROGRAM_DATA) ProgramData::restoreDefault();
+        if(restore & EEPROM_RESTORE_PROGRAM_DATA) {
+            ProgramData::restoreDefault();
+            ProgramSequence::restoreDefault();
+        }
         if(restoreProgramDataCRC(false)) test |= EEPROM_RESTORE_PROGRAM_DATA;
+        if(restoreSequenceCRC(false)) test |= EEPROM_RESTORE_PROGRAM_DATA;
 
         if(restore & EEPROM_RESTORE_SETTINGS)   Settings::restoreDefault();
         if(restoreSettingsCRC(false)) test |= EEPROM_RESTORE_SETTINGS;
@@ -133,6 +138,10 @@ namespace eeprom {
     bool restoreSettingsCRC(bool restore) {
         return testOrRestoreCRC((uint8_t*)&data.settings, sizeof(data.settings), restore);
     }
+
+    bool restoreSequenceCRC(bool restore) {
+        return testOrRestoreCRC((uint8_t*)&data.sequence, sizeof(data.sequence), restore);
+    }
 #endif
 
 }
@@ -21,6 +21,7 @@
 #include "AnalogInputs.h"
 #include "ProgramData.h"
 #include "Settings.h"
+#include "ProgramSequence.h"
 #include "cpu.h"
 
 #define EEPROM_MAGIC_STRING_LEN 4
@@ -48,6 +49,9 @@ namespace eeprom {
 
         Settings settings;
         uint16_t settingsCRC;
+
+        ProgramSequence::Code sequence[SEQUENCE_MAX_STEPS];
+        uint16_t sequenceCRC;
     } CHEALI_EEPROM_PACKED;
 
     extern Data data;
@@ -56,10 +60,12 @@ namespace eeprom {
     bool restoreCalibrationCRC(bool restore = true);
     bool restoreProgramDataCRC(bool restore = true);
     bool restoreSettingsCRC(bool restore = true);
+    bool restoreSequenceCRC(bool restore = true);
 #else
     inline bool restoreCalibrationCRC(bool restore = true)  { return false; }
     inline bool restoreProgramDataCRC(bool restore = true)  { return false; }
     inline bool restoreSettingsCRC(bool restore = true)     { return false; }
+    inline bool restoreSequenceCRC(bool restore = true)     { return false; }
 #endif
 
 #ifdef ENABLE_EEPROM_RESTORE_DEFAULT
@@ -0,0 +1,90 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "memory.h"
+#include "LcdPrint.h"
+#include "PrintNumber.h"
+#include "Time.h"
+#include "Hardware.h"
+
+/*
+ * compares the old "% 10, / 10" conversion with printUInt32()
+ * first line: division method, second line: PrintNumber
+ * (microseconds and cpu cycles per conversion)
+ */
+
+#define PRINT_BENCHMARK_CONVERSIONS 1000
+
+namespace PrintBenchmark {
+
+    volatile uint32_t value_;
+    char buf_[12];
+
+    char * printDivision(uint32_t value, char * buf)
+    {
+        char tmp[10];
+        uint8_t i = 0;
+        do {
+            tmp[i++] = (value % 10) + '0';
+            value /= 10;
+        } while(value);
+        while(i) {
+            *(buf++) = tmp[--i];
+        }
+        *buf = 0;
+        return buf;
+    }
+
+    uint32_t measure(bool division)
+    {
+        uint32_t t = Time::getInterrupts();
+        for(uint16_t i = 0; i < PRINT_BENCHMARK_CONVERSIONS; i++) {
+            uint32_t v = value_ + i;
+            if(division) printDivision(v, buf_);
+            else printUInt32(v, buf_);
+        }
+        t = Time::getInterrupts() - t;
+        //microseconds per conversion
+        return t * TIMER_INTERRUPT_PERIOD_MICROSECONDS / PRINT_BENCHMARK_CONVERSIONS;
+    }
+
+    void printResult(uint32_t us)
+    {
+        lcdPrintLong(us, 4);
+        lcdPrint_P(PSTR("us "));
+#ifdef F_CPU
+        lcdPrintLong(us * (F_CPU / 1000000), 6);
+        lcdPrint_P(PSTR("c"));
+#endif
+        lcdPrintSpaces();
+    }
+
+    void run()
+    {
+        //worst case: 10 digits
+        value_ = 3999999000;
+        do {
+            uint32_t div = measure(true);
+            uint32_t sub = measure(false);
+            lcdSetCursor0_0();
+            printResult(div);
+            lcdSetCursor0_1();
+            printResult(sub);
+        } while(true);
+    }
+
+} //namespace PrintBenchmark
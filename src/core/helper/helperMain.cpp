@@ -34,6 +34,10 @@ namespace LCDAnalyzer {
     void run();
 }
 
+namespace PrintBenchmark {
+    void run();
+}
+
 
 
 void helperMain()
@@ -55,4 +59,8 @@ void helperMain()
     ADCKeyboardAnalyzer::run();
 #endif
 
+#ifdef ENABLE_HELPER_PRINT_BENCHMARK
+    PrintBenchmark::run();
+#endif
+
 }
@@ -20,24 +20,32 @@
 #include "memory.h"
 #include "LcdPrint.h"
 #include "Blink.h"
+#include "Utils.h"
 
 //#define ENABLE_DEBUG
 #include "debug.h"
 
 
+//the longest menu (ProgramDataMenu) has less items
+#define EDIT_MENU_MAX_ITEMS     32
+
 namespace EditMenu {
 
-    uint16_t selector;
     EditCallBack editCallback;
     const struct StaticEditData * staticEditData_;
 
+    //visible items of staticEditData_ for the current selector
+    uint8_t items_[EDIT_MENU_MAX_ITEMS];
+    VisibleIndex index_ = { items_, EDIT_MENU_MAX_ITEMS };
+
     void printItem(uint8_t item);
     void editItem(uint8_t item, uint8_t key);
-    uint8_t getSelectedIndexOrSize(uint8_t item);
+    inline uint8_t getSelectedIndex(uint8_t item) { return items_[item]; }
 
     void initialize(const struct StaticEditData * staticEditData, const EditCallBack callback) {
         staticEditData_ = staticEditData;
         editCallback = callback;
+        invalidateVisibleIndex(index_);
         Menu::initialize(0);
         Menu::printMethod_ = printItem;
         Menu::editMethod_ = editItem;
@@ -47,7 +55,7 @@ namespace EditMenu {
 
     void printItem(uint8_t item)
     {
-        uint8_t index = getSelectedIndexOrSize(item);
+        uint8_t index = getSelectedIndex(item);
         const char * str = pgm::read(&staticEditData_[index].staticString);
         uint8_t dig = lcdPrint_P(str);
         if(Blink::getBlinkIndex() != item) {
@@ -63,7 +71,7 @@ namespace EditMenu {
 
     uint16_t * getEditAddress(uint8_t item)
     {
-        uint8_t index = getSelectedIndexOrSize(item);
+        uint8_t index = getSelectedIndex(item);
         cprintf::Data data = pgm::read(&staticEditData_[index].print.data);
         uint16_t * valuePtr = data.uint16Ptr;
         uint8_t type = pgm::read(&staticEditData_[index].print.type);
@@ -77,7 +85,7 @@ namespace EditMenu {
 
     uint16_t getEnableCondition(uint8_t item)
     {
-        uint8_t index = getSelectedIndexOrSize(item);
+        uint8_t index = getSelectedIndex(item);
         return pgm::read(&staticEditData_[index].enableCondition);
     }
 
@@ -85,7 +93,7 @@ namespace EditMenu {
     void editItem(uint8_t item, uint8_t key)
     {
         uint16_t * valuePtr = getEditAddress(item);
-        uint8_t index = getSelectedIndexOrSize(item);
+        uint8_t index = getSelectedIndex(item);
         EditData d = pgm::read(&staticEditData_[index].edit);
         int dir = 1;
         if(key == BUTTON_DEC) dir = -1;
@@ -111,38 +119,24 @@ namespace EditMenu {
         }
     }
 
-    void setSelector(uint16_t s) {
-        selector = s;
-        Menu::size_ = getSelectedIndexOrSize(0xff);
-        LogDebug(Menu::size_);
-    }
-
-    static bool predicate(uint16_t condition, uint16_t selector){
+    static VisibleItem isVisible(uint8_t index, uint32_t selector) {
+        uint16_t condition = pgm::read(&staticEditData_[index].enableCondition);
+        if(condition == EDIT_MENU_LAST)
+            return ItemLast;
         bool display = true;
         if(condition & EDIT_MENU_MANDATORY) {
             display = selector & EDIT_MENU_MANDATORY;
             condition ^= EDIT_MENU_MANDATORY;
         }
-        return display && (condition & selector);
+        if(display && (condition & selector))
+            return ItemVisible;
+        return ItemHidden;
     }
 
-    uint8_t getSelectedIndexOrSize(uint8_t item)
-    {
-        uint8_t index = 0, size = 0;
-        do {
-            uint16_t condition = pgm::read(&staticEditData_[index].enableCondition);
-            if(condition == EDIT_MENU_LAST) {
-                return size;
-            }
-            if(predicate(condition, selector)) {
-                if(item == 0) {
-                    return index;
-                }
-                item--;
-                size++;
-            }
-            index++;
-        } while(true);
+    void setSelector(uint16_t s) {
+        updateVisibleIndex(index_, s, isVisible);
+        Menu::size_ = index_.size;
+        LogDebug(Menu::size_);
     }
 
 }
@@ -19,6 +19,7 @@
 #include "Menu.h"
 #include "Calibration.h"
 #include "SettingsMenu.h"
+#include "SequenceMenu.h"
 #include "Hardware.h"
 #include "eeprom.h"
 #include "memory.h"
@@ -27,6 +28,7 @@ using namespace options;
 
 const Menu::StaticMenu optionsStaticMenu[] PROGMEM = {
         {string_settings,       SettingsMenu::run },
+        {ProgramMenus::string_sequence, SequenceMenu::run },
 #ifdef ENABLE_CALIBRATION
         {string_calibrate,      Calibration::run  },
 #endif
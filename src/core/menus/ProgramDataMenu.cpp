@@ -116,7 +116,7 @@ const EditMenu::StaticEditData editData[] PROGMEM = {
 
 {string_timeLimit,      COND_BATTERY+COND_LED, BATTERY(CHARGE_TIME, time),          {CE_STEP_TYPE_SMART, 0, ANALOG_MAX_TIME_LIMIT}},
 {string_capCoff,        COND_BATTERY,       BATTERY(PROCENTAGE, capCutoff),         {1, 1, 250}},
-{string_DCcycles,       COND_NiXX_Pb,       BATTERY(UNSIGNED, DCcycles),            {1, 0, 5}},
+{string_DCcycles,       COND_NiXX_Pb,       BATTERY(UNSIGNED, DCcycles),            {1, 0, 99}},
 {string_DCRestTime,     ADV(BATTERY),       BATTERY(MINUTES, DCRestTime),           {1, 1, 99}},
 {string_adaptiveDis,    ADV(BATTERY),       BATTERY(ON_OFF, enable_adaptiveDischarge),{1, 0, 1}},
 
@@ -49,6 +49,9 @@ namespace ProgramMenus {
             Program::DischargeChargeCycle,
 #endif
             Program::CapacityCheck,
+            Program::CapacityEstimate,
+            Program::IRTest,
+            Program::Sequence,
             Program::EditBattery,
     };
 
@@ -62,6 +65,9 @@ namespace ProgramMenus {
             Program::DischargeChargeCycle,
 #endif
             Program::CapacityCheck,
+            Program::CapacityEstimate,
+            Program::IRTest,
+            Program::Sequence,
             Program::EditBattery,
     };
 
@@ -70,6 +76,9 @@ namespace ProgramMenus {
             Program::Discharge,
             Program::DischargeChargeCycle,
             Program::CapacityCheck,
+            Program::CapacityEstimate,
+            Program::IRTest,
+            Program::Sequence,
             Program::EditBattery,
     };
 
@@ -79,6 +88,9 @@ namespace ProgramMenus {
             Program::FastCharge,
             Program::DischargeChargeCycle,
             Program::CapacityCheck,
+            Program::CapacityEstimate,
+            Program::IRTest,
+            Program::Sequence,
             Program::EditBattery,
     };
 
@@ -98,6 +110,9 @@ namespace ProgramMenus {
             string_storageAndBalance,
             string_dcCycle,
             string_capacityCheck,
+            string_capacityEstimate,
+            string_IRTest,
+            string_sequence,
             string_editBattery,
     };
 
@@ -0,0 +1,170 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2016  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "SequenceMenu.h"
+#include "ProgramSequence.h"
+#include "EditMenu.h"
+#include "LcdPrint.h"
+#include "Buzzer.h"
+#include "Utils.h"
+#include "memory.h"
+
+using namespace ProgramSequence;
+
+namespace SequenceMenu {
+
+    Step step;
+    uint8_t stepIndex_;
+
+    const char * const opStrings[] PROGMEM = {
+            string_end,
+            ProgramMenus::string_charge,
+            ProgramMenus::string_discharge,
+            ProgramMenus::string_storage,
+            ProgramMenus::string_balance,
+            string_rest,
+            string_repeat,
+            ProgramMenus::string_IRTest,
+    };
+    const cprintf::ArrayData opData  PROGMEM = {opStrings, &step.op};
+
+/*condition bits:*/
+#define COND_OP(op)     (1 << ProgramSequence::op)
+#define COND_PROGRAM    (COND_OP(Charge) + COND_OP(Discharge) + COND_OP(Storage) + COND_OP(Balance))
+
+    uint16_t getSelector() {
+        return 1 << step.op;
+    }
+
+    void printRate(int8_t dig) {
+        if(step.arg1 == 0) {
+            lcdPrintSpaces(dig - 4);
+            lcdPrint_P(string_default);
+        } else {
+            lcdPrintSpaces(dig - 5);
+            lcdPrintUnsigned(step.arg1 / 10, 2);
+            lcdPrintChar('.');
+            lcdPrintUnsigned(step.arg1 % 10, 1);
+            lcdPrintChar('C');
+        }
+    }
+
+    void changeRate(int dir) {
+        changeMinToMaxStep(&step.arg1, dir, 0, 99, 1);
+    }
+
+    void printTime(int8_t dig) {
+        if(step.time == 0) {
+            lcdPrintSpaces(dig - AnalogInputs::string_size_unlimited + 1);
+            lcdPrint_P(AnalogInputs::string_unlimited);
+        } else {
+            lcdPrintSpaces(dig - 4);
+            lcdPrintUnsigned(step.time * SEQUENCE_TIME_UNIT, 3);
+            lcdPrintChar('m');
+        }
+    }
+
+    void changeTime(int dir) {
+        changeMinToMaxStep(&step.time, dir, 0, 31, 1);
+    }
+
+    //only the steps before the Repeat step
+    uint8_t getMaxGoto() {
+        return stepIndex_ > 0 ? stepIndex_ : 1;
+    }
+
+    void changeGoto(int dir) {
+        changeMinToMaxStep(&step.arg1, dir, 1, getMaxGoto(), 1);
+    }
+
+/*
+|static string          |when to display    | how to display, see cprintf                   | how to edit |
+ */
+const EditMenu::StaticEditData editData[] PROGMEM = {
+{string_step,           EDIT_MENU_ALWAYS,   EDIT_STRING_ARRAY(opData),                  {1, 0, LAST_OPCODE-1}},
+{string_rate,           COND_OP(Charge)+COND_OP(Discharge), CPRINTF_METHOD(printRate),  STATIC_EDIT_METHOD(changeRate)},
+{string_endSOC,         COND_OP(Charge)+COND_OP(Discharge), {CP_TYPE_PROCENTAGE, 0, {&step.arg2}}, {1, 0, 100}},
+{string_time,           COND_PROGRAM,       CPRINTF_METHOD(printTime),                  STATIC_EDIT_METHOD(changeTime)},
+{string_time,           COND_OP(Rest),      {CP_TYPE_MINUTES, 0, {&step.arg1}},         {1, 1, 255}},
+{string_gotoStep,       COND_OP(Repeat),    {CP_TYPE_UNSIGNED, 0, {&step.arg1}},        STATIC_EDIT_METHOD(changeGoto)},
+{string_count,          COND_OP(Repeat),    {CP_TYPE_UNSIGNED, 0, {&step.arg2}},        {1, 1, 99}},
+
+{NULL,                  EDIT_MENU_LAST}
+};
+
+    void editCallback(uint16_t * value) {
+        if(value == &step.op) {
+            step.time = 0;
+            step.arg1 = 0;
+            step.arg2 = 0;
+            if(step.op == Rest) {
+                step.arg1 = 10;
+            } else if(step.op == Repeat) {
+                step.arg1 = 1;
+                step.arg2 = 1;
+            }
+        }
+        EditMenu::setSelector(getSelector());
+    }
+
+    void editStep(uint8_t index) {
+        int8_t item;
+        stepIndex_ = index;
+        loadStep(index, step);
+        if(step.op == Repeat && step.arg1 > getMaxGoto()) {
+            step.arg1 = getMaxGoto();
+        }
+        EditMenu::initialize(editData, editCallback);
+
+        do {
+            EditMenu::setSelector(getSelector());
+            item = EditMenu::run();
+
+            if(item < 0) break;
+            Step undo(step);
+            if(!EditMenu::runEdit()) {
+                step = undo;
+            } else {
+                Buzzer::soundSelect();
+            }
+        } while(true);
+        saveStep(index, step);
+    }
+
+    void printStep(uint8_t index) {
+        Step s;
+        loadStep(index, s);
+        lcdPrintUnsigned(index + 1, 1);
+        lcdPrintChar(' ');
+        lcdPrint_P(opStrings, s.op);
+    }
+
+} //namespace SequenceMenu
+
+void SequenceMenu::run()
+{
+    int8_t i = 0;
+    do {
+        Menu::initialize(SEQUENCE_MAX_STEPS);
+        Menu::printMethod_ = printStep;
+        Menu::setIndex(i);
+        i = Menu::run();
+        if(i >= 0) {
+            editStep(i);
+        }
+    } while(i >= 0);
+}
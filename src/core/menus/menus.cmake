@@ -3,7 +3,7 @@
 set(CORE_SOURCE
 EditMenu.cpp MainMenu.h  Menu.h           OptionsMenu.h        ProgramDataMenu.h  ProgramMenus.h    SettingsMenu.h
 EditMenu.h   Menu.cpp    OptionsMenu.cpp  ProgramDataMenu.cpp  ProgramMenus.cpp   SettingsMenu.cpp
-MainMenu.cpp
+MainMenu.cpp SequenceMenu.cpp SequenceMenu.h
 )
 
 CHEALI_ADD("CORE_SOURCE_FILES" "${CORE_SOURCE}")
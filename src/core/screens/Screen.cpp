@@ -29,6 +29,7 @@
 #include "Monitor.h"
 #include "PolarityCheck.h"
 #include "Utils.h"
+#include "Profiler.h"
 
 #include "ScreenPages.h"
 
@@ -39,7 +40,7 @@ namespace Screen {
 
     //see PAGE_PROGRAM
     //see PAGE_BATTERY
-    STATIC_ASSERT_MSG(ProgramData::LAST_BATTERY_CLASS == 6 && Program::LAST_PROGRAM_TYPE == 9 + 2, "see ScreenPages.h");
+    STATIC_ASSERT_MSG(ProgramData::LAST_BATTERY_CLASS == 6 && Program::LAST_PROGRAM_TYPE == 12 + 2, "see ScreenPages.h");
 
     uint32_t getConditions() {
         uint32_t c = 0;
@@ -52,28 +53,36 @@ namespace Screen {
         return c;
     }
 
+    uint8_t pageItems_[sizeOfArray(Pages::pageInfo)];
+    VisibleIndex pages_ = { pageItems_, sizeOfArray(pageItems_) };
+
+    VisibleItem isPageVisible(uint8_t i, uint32_t condition) {
+        if(pgm::read(&Pages::pageInfo[i].displayMethod) == NULL)
+            return ItemLast;
+        uint32_t enable = pgm::read(&Pages::pageInfo[i].conditionEnable);
+        uint32_t disable = pgm::read(&Pages::pageInfo[i].conditionDisable);
+        if((enable & condition) && (disable & condition) == 0)
+            return ItemVisible;
+        return ItemHidden;
+    }
+
     VoidMethod getPage(uint8_t page) {
-        uint8_t i = 0;
-        Pages::PageInfo info;
-        uint32_t condition = getConditions();
-        bool ok;
-        page++;
-        do {
-            info = pgm::read(&Pages::pageInfo[i]);
-            ok = ((info.conditionEnable & condition) > 0) && ((info.conditionDisable & condition) == 0);
-            if(ok) {
-                page--;
-            }
-            i++;
-        } while(page);
-        return info.displayMethod;
+        updateVisibleIndex(pages_, getConditions(), isPageVisible);
+        if(page >= pages_.size)
+            return NULL;
+        return pgm::read(&Pages::pageInfo[pageItems_[page]].displayMethod);
     }
 
     void displayPage() {
-        Screen::Cycle::storeCycleHistoryInfo();
         Blink::incBlinkTime();
 
-        getPage(pageNr_)();
+        VoidMethod page = getPage(pageNr_);
+        if(page == NULL && pages_.size > 0) {
+            //conditions changed, less pages are visible
+            pageNr_ = pages_.size - 1;
+            page = getPage(pageNr_);
+        }
+        if(page) page();
     }
 
     void displayAnimation();
@@ -85,7 +94,9 @@ namespace Screen {
 void Screen::doStrategy()
 {
     if(!PolarityCheck::runReversedPolarityInfo()) {
+        PROFILER_BEGIN(start);
         Screen::displayPage();
+        PROFILER_END(DisplayPage, start);
     }
 
     if(keyboardButton == BUTTON_INC && getPage(pageNr_ + 1) != NULL ) {
@@ -106,7 +117,7 @@ void Screen::powerOn()
 {
     Blink::startBlinkOn(0);
     pageNr_ = 0;
-    Screen::Cycle::resetCycleHistory();
+    invalidateVisibleIndex(pages_);
 }
 
 void Screen::powerOff() {}
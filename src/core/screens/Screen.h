@@ -37,8 +37,8 @@
 
 #define PAGE_START_INFO             (1L<<30)
 #define PAGE_BALANCE_PORT           (1L<<29)
-#define PAGE_PROGRAM(program)       (1<<(program))
-#define PAGE_BATTERY(_class)        ((1<<9)<<(_class))
+#define PAGE_PROGRAM(program)       (1L<<(program))
+#define PAGE_BATTERY(_class)        ((1L<<12)<<(_class))
 
 namespace Screen {
 
@@ -20,6 +20,7 @@
 #include "LcdPrint.h"
 #include "ProgramData.h"
 #include "TheveninMethod.h"
+#include "IRTestStrategy.h"
 #include "Settings.h"
 #include "Hardware.h"
 #include "Program.h"
@@ -42,6 +43,8 @@ namespace Screen { namespace Balancer {
     {
         if(type == AnalogInputs::Voltage)
             return ::Balancer::getPresumedV(cell);
+        if(Program::programType == Program::IRTest)
+            return IRTestStrategy::getReadableRthCell(cell);
         return TheveninMethod::getReadableRthCell(cell);
     }
 
@@ -152,3 +155,34 @@ void Screen::Balancer::displayResistance7_9() {
     displayBalanceInfo(6, AnalogInputs::Resistance);
 }
 
+
+void Screen::Balancer::displayImbalance()
+{
+    AnalogInputs::ValueType qmax = 0;
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        qmax = max(qmax, ::Balancer::getExcessCharge(c));
+    }
+
+    lcdSetCursor0_0();
+    lcdPrint_P(PSTR("dQ"));
+    lcdPrintCharge(qmax, 7);
+    lcdPrintTime(::Balancer::getBalanceTimeEstimate(), 7);
+
+    //cell excess charge relative to the largest one: 0..9
+    lcdSetCursor0_1();
+    lcdPrint_P(PSTR("cells: "));
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        if(AnalogInputs::connectedBalancePortCells & (1<<c)) {
+            uint8_t d = 0;
+            if(qmax > 0) {
+                uint32_t q = ::Balancer::getExcessCharge(c);
+                q *= 9;
+                d = q / qmax;
+            }
+            lcdPrintDigit(d);
+        } else {
+            lcdPrintChar(' ');
+        }
+    }
+    lcdPrintSpaces();
+}
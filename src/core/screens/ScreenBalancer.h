@@ -29,6 +29,8 @@ namespace Screen { namespace Balancer {
     void displayResistance4_6();
     void displayResistance7_9();
 
+    void displayImbalance();
+
 } };
 
 #endif /* SCREEN_BALANCER_H_ */
@@ -30,13 +30,40 @@
 #include "PolarityCheck.h"
 #include "ScreenCycle.h"
 
-//TODO: remove constant: 10 (move to #define)
+#include "CycleHistory.h"
 
 namespace Screen { namespace Cycle {
 
-    //TODO_NJ for cyclehistory
-    uint16_t cyclesHistoryCapacity[10];
-    uint32_t cyclesHistoryTime[10];
+    void printCycle(uint8_t cycle, char c, CycleHistory::Field field)
+    {
+        CycleHistory::Record r;
+        if(!CycleHistory::get(cycle, r)) {
+            r.value[field] = 0;
+        }
+        if(field == CycleHistory::Time) {
+            lcdPrintChar(c);
+            lcdPrintTime(uint32_t(r.value[field]) * CYCLE_HISTORY_TIME_UNIT, 6);
+        } else {
+            lcdPrintCharge(r.value[field], 8);
+        }
+    }
+
+    void displayStatistics()
+    {
+        const CycleHistory::Statistics &s = CycleHistory::getStatistics(false);
+        lcdSetCursor0_0();
+        lcdPrintChar(SCREEN_EMPTY_CELL_CHAR);
+        lcdPrintCharge(s.min, 7);
+        lcdPrintCharge(s.max, 8);
+        lcdPrintSpaces();
+
+        lcdSetCursor0_1();
+        lcdPrint_P(PSTR("avg"));
+        lcdPrintCharge(CycleHistory::getMean(false), 7);
+        lcdPrintSigned(CycleHistory::getFadeSlope()/10, 4);
+        lcdPrint_P(PSTR("/c"));
+        lcdPrintSpaces();
+    }
 
 } // namespace Screen
 } // namespace Cycle
@@ -44,34 +71,24 @@ namespace Screen { namespace Cycle {
 void Screen::Cycle::displayCycles()
 {
     uint8_t c, time = Blink::blinkTime_/8;
-    uint8_t all_scr = ProgramDCcycle::currentCycle/2 + 1;
-    c = time % all_scr;
+    //only the cycles kept in the history
+    uint8_t first_scr = CycleHistory::getFirstCycle()/2;
+    uint8_t all_scr = ProgramDCcycle::currentCycle/2 + 1 - first_scr;
+    bool statistics = CycleHistory::getStatistics(false).count > 0;
+    c = time % (all_scr + statistics);
+    if(c == all_scr) {
+        displayStatistics();
+        return;
+    }
+    c += first_scr;
     lcdSetCursor0_0();
-    lcdPrintUnsigned(c+1, 1);
-    lcdPrintChar(SCREEN_EMPTY_CELL_CHAR);
-    lcdPrintTime(cyclesHistoryTime[c*2], 6);
-    lcdPrintSpace1();
-    lcdPrintChar(SCREEN_FULL_CELL_CHAR);
-    lcdPrintTime(cyclesHistoryTime[c*2+1], 6);
+    lcdPrintUnsigned(c+1, 2);
+    printCycle(c*2, SCREEN_EMPTY_CELL_CHAR, CycleHistory::Time);
+    printCycle(c*2+1, SCREEN_FULL_CELL_CHAR, CycleHistory::Time);
     lcdPrintSpaces();
 
     lcdSetCursor0_1();
-    lcdPrintCharge(cyclesHistoryCapacity[c*2],8);
-    lcdPrintCharge(cyclesHistoryCapacity[c*2+1],8);
+    printCycle(c*2, 0, CycleHistory::Capacity);
+    printCycle(c*2+1, 0, CycleHistory::Capacity);
     lcdPrintSpaces();
 }
-
-void Screen::Cycle::resetCycleHistory()
-{
-    for (uint8_t i = 0; i < 10; i++) {
-        cyclesHistoryTime[i] = 0;
-        cyclesHistoryCapacity[i] = 0;
-    }
-}
-
-void Screen::Cycle::storeCycleHistoryInfo()
-{
-    uint8_t c = ProgramDCcycle::currentCycle;
-    cyclesHistoryTime[c] = Monitor::getTotalChargeDischargeTimeSec();
-    cyclesHistoryCapacity[c] = AnalogInputs::getRealValue(AnalogInputs::Cout);
-}
@@ -22,8 +22,6 @@
 namespace Screen { namespace Cycle {
 
     void displayCycles();
-    void resetCycleHistory();
-    void storeCycleHistoryInfo();
 
 } };
 
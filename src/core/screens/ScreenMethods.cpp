@@ -20,6 +20,8 @@
 #include "LcdPrint.h"
 #include "ProgramData.h"
 #include "TheveninMethod.h"
+#include "IRTestStrategy.h"
+#include "CapacityEstimateStrategy.h"
 #include "Settings.h"
 #include "Hardware.h"
 #include "Program.h"
@@ -30,11 +32,12 @@
 #include "PolarityCheck.h"
 #include "ScreenMethods.h"
 #include "Balancer.h"
+#include "LoopStats.h"
 
 namespace Screen { namespace Methods {
 
     void printCharge() {
-        lcdPrintCharge(AnalogInputs::getRealValue(AnalogInputs::Cout), 8);
+        AnalogInputs::printRealValue(AnalogInputs::Cout, 8);
     }
 
     void printCharAndTime() {
@@ -131,17 +134,40 @@ void Screen::Methods::displayTime()
 void Screen::Methods::displayR()
 {
     lcdSetCursor0_0();
+    bool IRTest = Program::programType == Program::IRTest;
     lcdPrint_P(PSTR("batt. R="));
-    lcdPrintResistance(TheveninMethod::getReadableBattRth(), 8);
+    lcdPrintResistance(IRTest ? IRTestStrategy::getReadableBattRth() : TheveninMethod::getReadableBattRth(), 8);
     lcdPrintSpaces();
     lcdSetCursor0_1();
     if(Monitor::isBalancePortConnected) {
         lcdPrint_P(PSTR("wires R="));
-        lcdPrintResistance(TheveninMethod::getReadableWiresRth(),8);
+        lcdPrintResistance(IRTest ? IRTestStrategy::getReadableWiresRth() : TheveninMethod::getReadableWiresRth(),8);
     }
     lcdPrintSpaces();
 }
 
+void Screen::Methods::displayCapacityEstimate()
+{
+    using namespace CapacityEstimateStrategy;
+    lcdSetCursor0_0();
+    if(state == Done) {
+        lcdPrint_P(PSTR("C="));
+        lcdPrintCharge(getCapacity(), 8);
+        lcdPrintUnsigned(getConfidence(), 4);
+        lcdPrintChar('%');
+    } else {
+        int8_t dig = lcdPrint_P(state == Discharge ? PSTR("disch.") : PSTR("rest"));
+        lcdPrintSpaces(8 - dig);
+        AnalogInputs::printRealValue(AnalogInputs::Cout, 8);
+    }
+    lcdPrintSpaces();
+    lcdSetCursor0_1();
+    lcdPrint_P(PSTR("OCV"));
+    lcdPrintVoltage(getOCVBefore(), 6);
+    lcdPrintVoltage(getOCVAfter(), 7);
+    lcdPrintSpaces();
+}
+
 void Screen::Methods::displayVinput()
 {
     lcdSetCursor0_0();
@@ -224,3 +250,30 @@ void Screen::Methods::displayEnergy()
     lcdPrintSpaces();
 }
 
+#ifdef ENABLE_LOOP_STATS
+namespace Screen { namespace Methods {
+    //max [ms], histogram (bucket shares in 1/10): 12 characters
+    void printLoopStats(char c, LoopStats::Histogram h) {
+        lcdPrintChar(c);
+        lcdPrintUnsigned(LoopStats::stats[h].max, 4);
+        lcdPrintSpace1();
+        for(uint8_t i = 0; i < LOOP_STATS_HISTOGRAM; i++) {
+            lcdPrintDigit(LoopStats::getShare(h, i));
+        }
+    }
+} }
+
+void Screen::Methods::displayLoopStats()
+{
+    lcdSetCursor0_0();
+    printLoopStats('L', LoopStats::LoopTime);
+    //16 characters: no space before the jitter
+    lcdPrintChar('J');
+    lcdPrintUnsigned(LoopStats::getJitter(), 3);
+    lcdPrintSpaces();
+
+    lcdSetCursor0_1();
+    printLoopStats('M', LoopStats::Latency);
+    lcdPrintSpaces();
+}
+#endif
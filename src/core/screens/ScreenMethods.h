@@ -32,6 +32,10 @@ namespace Screen { namespace Methods {
     void displayDeltaTextern();
     void displayDeltaFirst();
     void displayEnergy();
+    void displayCapacityEstimate();
+#ifdef ENABLE_LOOP_STATS
+    void displayLoopStats();
+#endif
 
     void printCharAndTime();
 } };
@@ -30,8 +30,8 @@
 namespace Screen { namespace Pages {
 
 /*condition bits:
- * 0..8:    PAGE_PROGRAM(..)
- * 9..16:   PAGE_BATTERY(CLASS)
+ * 0..11:   PAGE_PROGRAM(..)
+ * 12..17:  PAGE_BATTERY(CLASS)
  * 29:      PAGE_START_INFO
  * 30:      PAGE_BALANCE_PORT
 */
@@ -45,6 +45,7 @@ namespace Screen { namespace Pages {
             {Screen::StartInfo::displayStartInfo,   PAGE_START_INFO,                      PAGE_NONE},
             {Screen::Editable::displayLEDScreen,     PAGE_BATTERY(ProgramData::ClassLED), PAGE_START_INFO},
             {Screen::Methods::displayFirstScreen,   PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},
+            {Screen::Methods::displayCapacityEstimate, PAGE_PROGRAM(Program::CapacityEstimate), PAGE_START_INFO},
             {Screen::Cycle::displayCycles,          PAGE_PROGRAM(Program::CapacityCheck)+PAGE_PROGRAM(Program::DischargeChargeCycle), PAGE_START_INFO},
 
             {Screen::Methods::displayDeltaFirst,    PAGE_BATTERY(ProgramData::ClassNiXX), PAGE_START_INFO + PAGE_PROGRAM(Program::Discharge)},
@@ -62,12 +63,17 @@ BALANCER_PORTS_GT_6(
 BALANCER_PORTS_GT_6(
             {Screen::Balancer::displayResistance7_9,PAGE_BALANCE_PORT, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},)
 
+            {Screen::Balancer::displayImbalance,    PAGE_BALANCE_PORT, PAGE_START_INFO},
+
             {Screen::Methods::displayR,             PAGE_ALWAYS, PAGE_START_INFO + PAGE_PROGRAM(Program::Balance)},
 
             {Screen::Methods::displayTime,          PAGE_ALWAYS, PAGE_START_INFO},
             {Screen::Methods::displayTemperature,   PAGE_ALWAYS, PAGE_NONE},
             {Screen::Methods::displayCIVlimits,     PAGE_ALWAYS, PAGE_PROGRAM(Program::Balance)},
             {Screen::Methods::displayVinput,        PAGE_ALWAYS, PAGE_NONE},
+#ifdef ENABLE_LOOP_STATS
+            {Screen::Methods::displayLoopStats,     PAGE_ALWAYS, PAGE_START_INFO},
+#endif
 
             {NULL, PAGE_ALWAYS, PAGE_NONE}
     };
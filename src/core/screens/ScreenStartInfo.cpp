@@ -33,7 +33,7 @@
 namespace Screen {
 namespace StartInfo {
 
-    const char programString[] PROGMEM = "ChCBBlDiFCStSBCYCC";
+    const char programString[] PROGMEM = "ChCBBlDiFCStSBCYCCCEIRSQ";
 
     void printProgram2chars(Program::ProgramType prog)
     {
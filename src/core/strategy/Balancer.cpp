@@ -18,6 +18,8 @@
 #define __STDC_LIMIT_MACROS
 #include "ProgramData.h"
 #include "Balancer.h"
+#include "TheveninMethod.h"
+#include "StateOfCharge.h"
 #include "Screen.h"
 #include "Settings.h"
 #include "AnalogInputsPrivate.h"
@@ -31,13 +33,18 @@
 namespace Balancer {
     int8_t minCell;
     uint16_t balance;
+    uint8_t duty_[MAX_BALANCE_CELLS], newDuty_[MAX_BALANCE_CELLS];
+    volatile uint8_t output_;
     bool done;
     AnalogInputs::ValueType Von_[MAX_BALANCE_CELLS], Voff_[MAX_BALANCE_CELLS];
     bool savedVon;
     uint16_t startBalanceTimeSecondsU16_;
     uint16_t balancingEnded;
+    bool chargeBalancing;
 
     uint32_t IVtime_;
+    //estimated cell excess charge (above minimum cell)
+    AnalogInputs::ValueType excess_[MAX_BALANCE_CELLS];
     AnalogInputs::ValueType V_[MAX_BALANCE_CELLS];
 
     bool isWorking()  {
@@ -80,10 +87,14 @@ void Balancer::powerOn()
         AnalogInputs::ValueType vi = getV(i);
         Voff_[i] = Von_[i] = vi;
     }
+    for(uint8_t i = 0; i < MAX_BALANCE_CELLS; i++) {
+        excess_[i] = 0;
+    }
     balance = 0;
     done = false;
     setBalance(0);
     balancingEnded = 0;
+    chargeBalancing = false;
     resetMinCell();
 }
 
@@ -93,7 +104,7 @@ uint8_t Balancer::getCellMinV()
     AnalogInputs::ValueType vmin = UINT16_MAX;
     for(uint8_t i = 0; i < MAX_BALANCE_CELLS; i++) {
         if(AnalogInputs::connectedBalancePortCells & (1<<i)) {
-            AnalogInputs::ValueType v = getV(i);
+            AnalogInputs::ValueType v = getBalancingV(i);
             if(vmin > v) {
                 c = i;
                 vmin = v;
@@ -114,12 +125,29 @@ AnalogInputs::ValueType Balancer::getPresumedV(uint8_t cell)
     if(balance == 0)
         return getV(cell);
 
+    if(chargeBalancing) {
+        //bleeding lowers the cell current by the (average) bleed current
+        return getV(cell) + TheveninMethod::getCellVRth(cell, getBleedI(cell));
+    }
+
     if(savedVon)
         return (getV(cell) + Voff_[cell]) - Von_[cell] ;
     else
         return Voff_[cell];
 }
 
+AnalogInputs::ValueType Balancer::getBalancingV(uint8_t cell)
+{
+    AnalogInputs::ValueType v = getPresumedV(cell);
+    if(chargeBalancing) {
+        //presumed unloaded cell voltage: Vth = V - I*Rth
+        AnalogInputs::ValueType VRth = TheveninMethod::getCellVRth(cell, AnalogInputs::getIout());
+        if(v > VRth) v -= VRth;
+        else v = 0;
+    }
+    return v;
+}
+
 void Balancer::endBalancing()
 {
     setBalance(0);
@@ -134,6 +162,47 @@ void Balancer::powerOff()
 }
 
 
+AnalogInputs::ValueType Balancer::getBleedI(uint8_t cell)
+{
+    uint32_t i = BALANCER_I;
+    i *= duty_[cell];
+    i /= BALANCER_PWM_STEPS;
+    return i;
+}
+
+uint8_t Balancer::calculateDuty(uint8_t cell, AnalogInputs::ValueType vmin)
+{
+    AnalogInputs::ValueType v = getBalancingV(cell);
+    if(v <= vmin)
+        return 0;
+    uint32_t duty;
+    uint32_t ccTime = 0;
+    AnalogInputs::ValueType I = AnalogInputs::getIout();
+    AnalogInputs::ValueType C = AnalogInputs::getRealValue(AnalogInputs::Cout);
+    if(chargeBalancing && I > 0 && C < ProgramData::battery.capacity) {
+        //remaining constant current time
+        ccTime = ProgramData::battery.capacity - C;
+        ccTime *= 3600;
+        ccTime /= I;
+    }
+    if(ccTime > 0) {
+        //spread bleeding over the rest of the charge, cells which
+        //would dominate the CV tail bleed with full duty
+        duty = getBleedTime(cell);
+        duty *= BALANCER_PWM_STEPS;
+        duty /= ccTime;
+    } else {
+        //duty proportional to the cell excess voltage (charge)
+        duty = v - vmin;
+        duty *= BALANCER_PWM_STEPS;
+        duty /= BALANCER_FULL_DUTY_V;
+    }
+    duty++;
+    if(duty > BALANCER_PWM_STEPS)
+        duty = BALANCER_PWM_STEPS;
+    return duty;
+}
+
 void Balancer::setBalance(uint16_t v)
 {
     if(balance != 0 && v == 0)
@@ -141,20 +210,51 @@ void Balancer::setBalance(uint16_t v)
 
     balance = v;
     AnalogInputs::resetStable();
-    if(!done)
-        hardware::setBalancer(v);
+    if(!done) {
+        //cells without calculated duty (e.g. BalancePortAnalyzer) bleed all the time
+        for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+            uint8_t d = 0;
+            if(v & (1<<c)) {
+                d = newDuty_[c];
+                if(d == 0) d = BALANCER_PWM_STEPS;
+            }
+            duty_[c] = d;
+        }
+    }
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        newDuty_[c] = 0;
+    }
+}
+
+void Balancer::doInterrupt()
+{
+    static uint8_t step = 0;
+    if(++step >= BALANCER_PWM_STEPS)
+        step = 0;
+
+    uint8_t out = 0;
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        if(duty_[c] > step)
+            out |= 1<<c;
+    }
+    if(out != output_) {
+        output_ = out;
+        hardware::setBalancer(out);
+    }
 }
 
 void Balancer::startBalacing()
 {
-    //test if battery has recovered after last balancing
-    if(!isStable(balancerStartStableCount) || !AnalogInputs::isOutStable())
-        return;
+    if(!chargeBalancing) {
+        //test if battery has recovered after last balancing
+        if(!isStable(balancerStartStableCount) || !AnalogInputs::isOutStable())
+            return;
+    }
 
-    if(minCell < 0) {
+    if(minCell < 0 || chargeBalancing) {
         minCell = getCellMinV();
     }
-    AnalogInputs::ValueType vmin = getV(minCell);
+    AnalogInputs::ValueType vmin = getBalancingV(minCell);
 
     //test if we can still discharge
     bool off = true;
@@ -167,7 +267,7 @@ void Balancer::startBalacing()
                 off = true;
                 break;
             }
-            if(v > vmin) {
+            if(getBalancingV(i) > vmin) {
                 off = false;
             }
             Von_[i] = Voff_[i] = v;
@@ -189,15 +289,17 @@ uint16_t Balancer::calculateBalance()
     if(minCell < 0) {
         return 0;
     }
-    AnalogInputs::ValueType vmin = getPresumedV(minCell);
+    AnalogInputs::ValueType vmin = getBalancingV(minCell);
     uint16_t retu = 0, cell = 1;
     for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        uint8_t d = 0;
         if(AnalogInputs::connectedBalancePortCells & cell) {
-            AnalogInputs::ValueType v = getPresumedV(c);
-            if(v > vmin) {
+            d = calculateDuty(c, vmin);
+            if(d) {
                 retu |= cell;
             }
         }
+        newDuty_[c] = d;
         cell <<= 1;
     }
     return retu;
@@ -232,6 +334,7 @@ uint16_t Balancer::getBalanceTime()
 Strategy::statusType Balancer::doStrategy()
 {
     LogDebug("minCell=", minCell, " balance=", balance, " conCells=", connectedCells);
+    updateImbalance();
     if(balance == 0) {
             startBalacing();
     } else {
@@ -277,3 +380,52 @@ AnalogInputs::ValueType Balancer::calculatePerCell(AnalogInputs::ValueType v)
     return v/cells;
 }
 
+
+void Balancer::updateImbalance()
+{
+    AnalogInputs::ValueType vmin = UINT16_MAX;
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        if(AnalogInputs::connectedBalancePortCells & (1<<c)) {
+            AnalogInputs::ValueType v = getBalancingV(c);
+            if(v < vmin) vmin = v;
+        }
+    }
+
+    //cell state of charge difference (OCV curve)
+    uint16_t socMin = StateOfCharge::getSOC(vmin);
+
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        uint32_t q = 0;
+        if(AnalogInputs::connectedBalancePortCells & (1<<c)) {
+            q = StateOfCharge::getSOC(getBalancingV(c)) - socMin;
+            q *= ProgramData::battery.capacity;
+            q /= SOC_FULL;
+        }
+        //low pass filter on the cell voltage history
+        q += 3*uint32_t(excess_[c]);
+        excess_[c] = q/4;
+    }
+}
+
+AnalogInputs::ValueType Balancer::getExcessCharge(uint8_t cell)
+{
+    return excess_[cell];
+}
+
+uint16_t Balancer::getBleedTime(uint8_t cell)
+{
+    uint32_t t = excess_[cell];
+    t *= 3600;
+    t /= BALANCER_I;
+    if(t > UINT16_MAX) t = UINT16_MAX;
+    return t;
+}
+
+uint16_t Balancer::getBalanceTimeEstimate()
+{
+    uint16_t t = 0;
+    for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+        t = max(t, getBleedTime(c));
+    }
+    return t;
+}
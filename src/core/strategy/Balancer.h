@@ -28,6 +28,16 @@
 #define BALANCER_I ANALOG_AMP(0.160) //default 160mA
 #endif
 
+//balancer PWM period: BALANCER_PWM_STEPS timer interrupts
+#ifndef BALANCER_PWM_STEPS
+#define BALANCER_PWM_STEPS 16
+#endif
+
+//cells above minCell by at least this value bleed with full duty
+#ifndef BALANCER_FULL_DUTY_V
+#define BALANCER_FULL_DUTY_V ANALOG_VOLT(0.024)
+#endif
+
 
 #include "Strategy.h"
 
@@ -39,10 +49,14 @@ namespace Balancer {
     extern const Strategy::VTable vtable;
 
     extern uint16_t balance;
+    extern uint8_t duty_[MAX_BALANCE_CELLS];
     extern bool savedVon;
     extern int8_t minCell;
     extern bool done;
     extern uint16_t balancingEnded;
+    //balancing during constant current charge, cell voltages are
+    //compensated using the TheveninMethod cell resistances
+    extern bool chargeBalancing;
 
     void powerOn();
     void powerOff();
@@ -53,10 +67,15 @@ namespace Balancer {
 
     uint16_t calculateBalance();
     void setBalance(uint16_t v);
+    uint8_t calculateDuty(uint8_t cell, AnalogInputs::ValueType vmin);
+    AnalogInputs::ValueType getBleedI(uint8_t cell);
+    //called from the timer interrupt
+    void doInterrupt();
     uint8_t getCellMinV();
 
     AnalogInputs::ValueType getV(uint8_t cell);
     AnalogInputs::ValueType getPresumedV(uint8_t cell);
+    AnalogInputs::ValueType getBalancingV(uint8_t cell);
     inline AnalogInputs::ValueType getRealV(uint8_t cell) { return getPresumedV(cell); }
     inline void resetMinCell() { minCell = -1; }
     bool isWorking();
@@ -68,6 +87,12 @@ namespace Balancer {
     void endBalancing();
 
     AnalogInputs::ValueType calculatePerCell(AnalogInputs::ValueType v);
+
+    //pack imbalance model
+    void updateImbalance();
+    AnalogInputs::ValueType getExcessCharge(uint8_t cell);
+    uint16_t getBleedTime(uint8_t cell);
+    uint16_t getBalanceTimeEstimate();
 };
 
 #endif /* BALANCER_H_ */
@@ -0,0 +1,143 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Pawel Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#define __STDC_LIMIT_MACROS
+#include "CapacityEstimateStrategy.h"
+#include "TheveninDischargeStrategy.h"
+#include "StateOfCharge.h"
+#include "ProgramData.h"
+#include "Buzzer.h"
+#include "Time.h"
+#include "memory.h"
+
+namespace CapacityEstimateStrategy {
+    const Strategy::VTable vtable PROGMEM = {
+        powerOn,
+        powerOff,
+        doStrategy
+    };
+
+    State state;
+    uint16_t startTime_;
+    AnalogInputs::ValueType Cstart_;
+    AnalogInputs::ValueType Q_;
+    AnalogInputs::ValueType OCV_[2];
+    AnalogInputs::ValueType capacity_;
+    uint8_t confidence_;
+
+    bool isRested() {
+        uint16_t rest = ProgramData::battery.DCRestTime * 60;
+        return Time::diffU16(startTime_, Time::getSecondsU16()) > rest;
+    }
+
+    //SOC error caused by CAPACITY_ESTIMATE_OCV_ERROR
+    uint16_t getSOCError(AnalogInputs::ValueType v) {
+        AnalogInputs::ValueType dv = CAPACITY_ESTIMATE_OCV_ERROR;
+        if(v < dv) dv = v;
+        return (StateOfCharge::getSOC(v + CAPACITY_ESTIMATE_OCV_ERROR) - StateOfCharge::getSOC(v - dv)) / 2;
+    }
+
+    void calculateCapacity() {
+        uint16_t soc1 = StateOfCharge::getSOC(OCV_[0]);
+        uint16_t soc2 = StateOfCharge::getSOC(OCV_[1]);
+        capacity_ = 0;
+        confidence_ = 0;
+        if(soc1 <= soc2)
+            return;
+
+        uint16_t dSOC = soc1 - soc2;
+        uint32_t C = Q_;
+        C *= SOC_FULL;
+        C /= dSOC;
+        if(C > UINT16_MAX) C = UINT16_MAX;
+        capacity_ = C;
+
+        uint32_t error = getSOCError(OCV_[0]);
+        error += getSOCError(OCV_[1]);
+        error *= 100;
+        error /= dSOC;
+        if(error < 100) confidence_ = 100 - error;
+    }
+
+    void startRest() {
+        startTime_ = Time::getSecondsU16();
+    }
+
+} // namespace CapacityEstimateStrategy
+
+AnalogInputs::ValueType CapacityEstimateStrategy::getOCVBefore()    { return OCV_[0]; }
+AnalogInputs::ValueType CapacityEstimateStrategy::getOCVAfter()     { return OCV_[1]; }
+AnalogInputs::ValueType CapacityEstimateStrategy::getCapacity()     { return capacity_; }
+uint8_t CapacityEstimateStrategy::getConfidence()                   { return confidence_; }
+
+void CapacityEstimateStrategy::powerOn()
+{
+    OCV_[0] = OCV_[1] = 0;
+    capacity_ = 0;
+    confidence_ = 0;
+    state = RestBefore;
+    startRest();
+}
+
+void CapacityEstimateStrategy::powerOff()
+{
+    if(state == Discharge) {
+        TheveninDischargeStrategy::powerOff();
+    }
+}
+
+Strategy::statusType CapacityEstimateStrategy::doStrategy()
+{
+    AnalogInputs::ValueType C = AnalogInputs::getRealValue(AnalogInputs::Cout);
+    switch(state) {
+    case RestBefore:
+        if(isRested()) {
+            OCV_[0] = StateOfCharge::getOCV();
+            Cstart_ = C;
+            state = Discharge;
+            TheveninDischargeStrategy::powerOn();
+        }
+        break;
+    case Discharge: {
+        uint32_t depth = ProgramData::battery.capacity;
+        depth *= CAPACITY_ESTIMATE_DEPTH;
+        depth /= 100;
+        AnalogInputs::ValueType dC = C - Cstart_;
+        if(dC >= depth || TheveninDischargeStrategy::doStrategy() == Strategy::COMPLETE) {
+            TheveninDischargeStrategy::powerOff();
+            Q_ = dC;
+            state = RestAfter;
+            startRest();
+        }
+        break;
+    }
+    case RestAfter:
+        if(isRested()) {
+            OCV_[1] = StateOfCharge::getOCV();
+            calculateCapacity();
+            state = Done;
+            if(!Strategy::exitImmediately) {
+                Buzzer::soundProgramComplete();
+            }
+        }
+        break;
+    default:
+        //keep the results on the screen
+        return Strategy::exitImmediately ? Strategy::COMPLETE : Strategy::RUNNING;
+    }
+    return Strategy::RUNNING;
+}
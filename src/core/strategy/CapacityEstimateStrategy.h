@@ -0,0 +1,46 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Pawel Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef CAPACITYESTIMATESTRATEGY_H_
+#define CAPACITYESTIMATESTRATEGY_H_
+
+#include "Strategy.h"
+
+//shallow discharge between two rested OCV points:
+//capacity = Q / (SOC(OCV1) - SOC(OCV2))
+#define CAPACITY_ESTIMATE_DEPTH         20                  // % of the battery capacity
+#define CAPACITY_ESTIMATE_OCV_ERROR     ANALOG_VOLT(0.005)  //assumed OCV error per cell
+
+namespace CapacityEstimateStrategy {
+
+    enum State { RestBefore, Discharge, RestAfter, Done };
+
+    extern const Strategy::VTable vtable;
+    extern State state;
+
+    void powerOn();
+    Strategy::statusType doStrategy();
+    void powerOff();
+
+    AnalogInputs::ValueType getOCVBefore();
+    AnalogInputs::ValueType getOCVAfter();
+    AnalogInputs::ValueType getCapacity();
+    //0..100%, based on the OCV curve slope at both points
+    uint8_t getConfidence();
+};
+
+#endif /* CAPACITYESTIMATESTRATEGY_H_ */
@@ -18,6 +18,19 @@
 #include "Discharger.h"
 #include "Utils.h"
 #include "Settings.h"
+#include "Time.h"
+
+#ifndef DISCHARGER_THERMAL_TIME_CONSTANT
+#define DISCHARGER_THERMAL_TIME_CONSTANT    120 //seconds
+#endif
+//heatsink thermal resistance in 0.01 C/W (initial value)
+#ifndef DISCHARGER_THERMAL_R
+#define DISCHARGER_THERMAL_R                200
+#endif
+//temperature error gain
+#define DISCHARGER_THERMAL_GAIN             4
+//initial ambient temperature, corrected by the Tintern readings
+#define DISCHARGER_T_AMBIENT                ANALOG_CELCIUS(25)
 
 
 namespace Discharger {
@@ -30,13 +43,105 @@ namespace Discharger {
     uint16_t getValue() { return value_; }
     AnalogInputs::ValueType getIout() { return IoutSet_; }
 
+#ifdef ENABLE_T_INTERNAL
+    //first-order heatsink model: T = Tambient + R * P_filtered
+    //P_filtered - power low pass filtered with the heatsink time constant
+    AnalogInputs::ValueType Tambient_;
+    uint32_t Pfiltered_;    //ANALOG_WATT << 8
+    uint16_t R_;            //0.01 C/W
+    uint16_t lastUpdate_;
+    uint16_t ambientRiseTime_;
+    AnalogInputs::ValueType Plimit_;
+    bool tempcutoff_;
+
+    //Tambient_ is kept between discharges - the heatsink may still be hot
+    void resetThermalModel()
+    {
+        Pfiltered_ = 0;
+        R_ = DISCHARGER_THERMAL_R;
+        Plimit_ = MAX_DISCHARGE_P;
+        lastUpdate_ = Time::getMilisecondsU16();
+    }
+
+    void updateThermalModel(AnalogInputs::ValueType T)
+    {
+        uint16_t now = Time::getMilisecondsU16();
+        uint16_t dt = Time::diffU16(lastUpdate_, now);
+        if(dt < 100)
+            return;
+        if(dt > 10000)
+            dt = 10000;
+        lastUpdate_ = now;
+
+        //the ambient temperature falls with every colder reading,
+        //and rises slowly (0.01C/s) when the heatsink is not loaded
+        ambientRiseTime_ += dt;
+        if(T < Tambient_) {
+            Tambient_ = T;
+        } else if(ambientRiseTime_ >= 1000) {
+            ambientRiseTime_ = 0;
+            if(T > Tambient_ && (Pfiltered_ >> 8) < ANALOG_WATT(0.5))
+                Tambient_++;
+        }
+
+        //Pf += (P - Pf) * dt/tau
+        int32_t dP = AnalogInputs::getRealValue(AnalogInputs::Pout);
+        dP <<= 8;
+        dP -= Pfiltered_;
+        dP /= DISCHARGER_THERMAL_TIME_CONSTANT;
+        dP *= dt;
+        dP /= 1000;
+        Pfiltered_ += dP;
+
+        //fit R when the heatsink is loaded
+        AnalogInputs::ValueType Pf = Pfiltered_ >> 8;
+        if(Pf > ANALOG_WATT(2.0) && T > Tambient_ + ANALOG_CELCIUS(2.0)) {
+            uint32_t R = T - Tambient_;
+            R *= ANALOG_WATT(1.0);
+            R /= Pf;
+            int32_t dR = R;
+            dR -= R_;
+            R_ += dR / 8;
+        }
+    }
+
+    AnalogInputs::ValueType getThermalMaxP()
+    {
+        AnalogInputs::ValueType T = AnalogInputs::getRealValue(AnalogInputs::Tintern);
+        //the model holds the temperature below the cutoff
+        AnalogInputs::ValueType Tset = settings.dischargeTempOff - Settings::TempDifference/2;
+
+        updateThermalModel(T);
+
+        //hard cutoff at dischargeTempOff (with hysteresis)
+        testTintern(tempcutoff_, settings.dischargeTempOff - Settings::TempDifference, settings.dischargeTempOff);
+        if(tempcutoff_)
+            return 0;
+
+        //steady state power for Tset and a correction of the current temperature error
+        int32_t P = Tset;
+        P -= Tambient_;
+        P += DISCHARGER_THERMAL_GAIN * (int32_t(Tset) - T);
+        if(P <= 0 || R_ == 0)
+            return 0;
+        P *= ANALOG_WATT(1.0);
+        P /= R_;
+        if(P > MAX_DISCHARGE_P)
+            P = MAX_DISCHARGE_P;
+
+        //avoid small changes - each current change resets the measurement
+        if(absDiff(AnalogInputs::ValueType(P), Plimit_) > Plimit_/16)
+            Plimit_ = P;
+        return Plimit_;
+    }
+#endif
+
     AnalogInputs::ValueType getMaxIout()
     {
+        AnalogInputs::ValueType P = MAX_DISCHARGE_P;
 #ifdef ENABLE_T_INTERNAL
-        bool tempcutoff;
-        testTintern(tempcutoff, settings.dischargeTempOff - Settings::TempDifference, settings.dischargeTempOff);
-
-        if(tempcutoff)
+        P = getThermalMaxP();
+        if(P == 0)
             return 0;
 #endif
 
@@ -44,7 +149,7 @@ namespace Discharger {
         if (v == 0) {
             v = 1;
         }
-        AnalogInputs::ValueType i = AnalogInputs::evalI(MAX_DISCHARGE_P, v);
+        AnalogInputs::ValueType i = AnalogInputs::evalI(P, v);
 
         if(i > settings.maxId)
             i = settings.maxId;
@@ -54,6 +159,9 @@ namespace Discharger {
 
 void Discharger::initialize()
 {
+#ifdef ENABLE_T_INTERNAL
+    Tambient_ = DISCHARGER_T_AMBIENT;
+#endif
     on_ = true;
     powerOff();
 }
@@ -86,6 +194,9 @@ void Discharger::powerOn()
 
     setValue(0);
     IoutSet_ = 0;
+#ifdef ENABLE_T_INTERNAL
+    resetThermalModel();
+#endif
     hardware::setDischargerOutput(true);
     on_ = true;
 }
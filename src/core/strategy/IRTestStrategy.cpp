@@ -0,0 +1,150 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Pawel Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "IRTestStrategy.h"
+#include "Discharger.h"
+#include "Thevenin.h"
+#include "Buzzer.h"
+#include "Time.h"
+#include "memory.h"
+
+namespace IRTestStrategy {
+    const Strategy::VTable vtable PROGMEM = {
+        powerOn,
+        powerOff,
+        doStrategy
+    };
+
+    enum State { LowLoad, HighLoad, Done };
+
+    //cells, battery, output
+    static const uint8_t VBattery = MAX_BALANCE_CELLS;
+    static const uint8_t VOutput = MAX_BALANCE_CELLS + 1;
+    static const uint8_t VALUES = MAX_BALANCE_CELLS + 2;
+
+    State state_;
+    bool sampling_;
+    uint16_t startTime_;
+    AnalogInputs::ValueType I1_;
+    AnalogInputs::ValueType V1_[VALUES];
+    Resistance R_[VALUES];
+
+    AnalogInputs::ValueType getV(uint8_t i) {
+        if(i == VBattery) return AnalogInputs::getVbattery();
+        if(i == VOutput) return AnalogInputs::getVout();
+        return AnalogInputs::getRealValue(AnalogInputs::Name(AnalogInputs::Vb1 + i));
+    }
+
+    void sampleLowLoad() {
+        I1_ = AnalogInputs::getIout();
+        for(uint8_t i = 0; i < VALUES; i++) {
+            V1_[i] = getV(i);
+        }
+    }
+
+    void calculateRth() {
+        AnalogInputs::ValueType I2 = AnalogInputs::getIout();
+        for(uint8_t i = 0; i < VALUES; i++) {
+            R_[i].iV = 0;
+            R_[i].uI = 0;
+            AnalogInputs::ValueType V2 = getV(i);
+            if(I2 > I1_ && V1_[i] > V2) {
+                R_[i].iV = V1_[i] - V2;
+                R_[i].uI = I2 - I1_;
+            }
+        }
+    }
+
+    void setLoad(AnalogInputs::ValueType I) {
+        Discharger::trySetIout(I);
+        startTime_ = Time::getMilisecondsU16();
+        sampling_ = false;
+    }
+
+    uint16_t getLoadTime() {
+        return state_ == LowLoad ? IR_TEST_LOW_LOAD_TIME : IR_TEST_HIGH_LOAD_TIME;
+    }
+
+} // namespace IRTestStrategy
+
+AnalogInputs::ValueType IRTestStrategy::getReadableRthCell(uint8_t cell) { return R_[cell].getReadableRth(); }
+AnalogInputs::ValueType IRTestStrategy::getReadableBattRth()             { return R_[VBattery].getReadableRth(); }
+AnalogInputs::ValueType IRTestStrategy::getReadableWiresRth()
+{
+    AnalogInputs::ValueType Rout = R_[VOutput].getReadableRth();
+    AnalogInputs::ValueType Rbatt = getReadableBattRth();
+    if(Rout > Rbatt) return Rout - Rbatt;
+    return 0;
+}
+
+void IRTestStrategy::powerOn()
+{
+    for(uint8_t i = 0; i < VALUES; i++) {
+        R_[i].iV = 0;
+        R_[i].uI = 0;
+    }
+    AnalogInputs::setFastMeasurement(true);
+    Discharger::powerOn();
+    state_ = LowLoad;
+    setLoad(Strategy::maxI / IR_TEST_LOW_LOAD_DIVIDER);
+}
+
+void IRTestStrategy::powerOff()
+{
+    Discharger::powerOff();
+    AnalogInputs::setFastMeasurement(false);
+}
+
+Strategy::statusType IRTestStrategy::doStrategy()
+{
+    if(state_ == Done) {
+        //keep the results on the screen
+        return Strategy::exitImmediately ? Strategy::COMPLETE : Strategy::RUNNING;
+    }
+
+    if(AnalogInputs::getVbattery() < Strategy::endV) {
+        //battery is empty, don't load it any more
+        powerOff();
+        state_ = Done;
+        return Strategy::COMPLETE;
+    }
+
+    if(Time::diffU16(startTime_, Time::getMilisecondsU16()) < getLoadTime()) {
+        return Strategy::RUNNING;
+    }
+    if(!sampling_) {
+        //take a measurement done entirely after the load time
+        AnalogInputs::resetMeasurement();
+        sampling_ = true;
+        return Strategy::RUNNING;
+    }
+
+    if(state_ == LowLoad) {
+        sampleLowLoad();
+        state_ = HighLoad;
+        setLoad(Strategy::maxI);
+    } else {
+        calculateRth();
+        powerOff();
+        state_ = Done;
+        if(!Strategy::exitImmediately) {
+            Buzzer::soundProgramComplete();
+        }
+    }
+    return Strategy::RUNNING;
+}
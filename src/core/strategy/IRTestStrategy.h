@@ -0,0 +1,42 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Pawel Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef IRTESTSTRATEGY_H_
+#define IRTESTSTRATEGY_H_
+
+#include "Strategy.h"
+
+//two point DC internal resistance test:
+//R = (V(I1) - V(I2)) / (I2 - I1), I1 = I2/IR_TEST_LOW_LOAD_DIVIDER
+#define IR_TEST_LOW_LOAD_DIVIDER    5
+#define IR_TEST_LOW_LOAD_TIME       2000    //miliseconds
+#define IR_TEST_HIGH_LOAD_TIME      1000    //miliseconds
+
+namespace IRTestStrategy {
+
+    extern const Strategy::VTable vtable;
+
+    void powerOn();
+    Strategy::statusType doStrategy();
+    void powerOff();
+
+    AnalogInputs::ValueType getReadableRthCell(uint8_t cell);
+    AnalogInputs::ValueType getReadableBattRth();
+    AnalogInputs::ValueType getReadableWiresRth();
+};
+
+#endif /* IRTESTSTRATEGY_H_ */
@@ -30,58 +30,162 @@
 #include "LcdPrint.h"
 #include "Screen.h"
 #include "TheveninMethod.h"
+#include "StateOfCharge.h"
+#include "CycleHistory.h"
 
 #if defined(ENABLE_FAN) && defined(ENABLE_T_INTERNAL)
 #define MONITOR_T_INTERNAL_FAN
 #endif
 
+//fan PWM period: FAN_PWM_STEPS timer interrupts
+#define FAN_PWM_STEPS           16
+//fan controller output: 0..FAN_MAX_OUTPUT
+#define FAN_MAX_OUTPUT          255
+//lower outputs may stall the fan
+#define FAN_MIN_OUTPUT          64
+#define FAN_UPDATE_PERIOD       1000 //ms
+#define FAN_INTEGRAL_TIME       30   //seconds
+
 
 
 namespace Monitor {
     volatile uint8_t i_externalError;
-    uint32_t etaDeltaSec;
-    uint32_t etaStartTimeCalc;
 
     bool isBalancePortConnected;
 
     bool on_;
-    uint8_t procent_;
     uint32_t startTime_totalTime_;
     uint32_t totalBalanceTime_;
     uint32_t totalChargDischargeTime_;
 
+    uint16_t socMeasurement_;
+
     uint16_t Vout_plus_adcMinLimit_;
     uint16_t Vout_plus_adcMaxLimit_;
 
-    void calculateDeltaProcentTimeSec();
+#ifdef MONITOR_T_INTERNAL_FAN
+    volatile uint8_t fanDuty_;
+    bool fanState_;
+    //PI integral, FAN_MAX_OUTPUT << 4
+    int16_t fanIntegral_;
+    uint16_t fanLastUpdate_;
+
+    uint8_t calculateFanOutput();
+#endif
+
+    uint32_t getCVTimeConstant();
+    uint32_t getChargeETATime();
+    uint32_t getDischargeETATime();
 
 } // namespace Monitor
 
-void Monitor::calculateDeltaProcentTimeSec()
+//CV phase current decays exponentially: I(t) = I0*exp(-t/tau)
+//tau = Rth * dQ/dV, dQ/dV is taken from the OCV curve 100mV below the end voltage
+uint32_t Monitor::getCVTimeConstant()
 {
-    uint32_t etaSec;
-    uint8_t procent = Monitor::getChargeProcent();
-    if(procent_ < procent) {
-        procent_ = procent;
-        etaSec = Monitor::etaStartTimeCalc-Monitor::getTimeSec();
-        etaStartTimeCalc = Monitor::getTimeSec();
-        if (etaSec > etaDeltaSec)  {
-            etaDeltaSec=etaSec; // find longer time for deltaprocent
-        }
+    uint16_t cells = ProgramData::battery.cells;
+    if(!TheveninMethod::isBattRthMeasured() || cells == 0)
+        return 0;
+
+    AnalogInputs::ValueType Vend = Strategy::endV / cells;
+    uint16_t dSoc = StateOfCharge::getSOC(Vend) - StateOfCharge::getSOC(Vend - ANALOG_VOLT(0.100));
+
+    //tau = Rth * capacity * dSoc/SOC_FULL / (cells * 100mV), mOhm * mAh / mV = 3.6s
+    uint32_t tau = TheveninMethod::getReadableBattRth();
+    tau *= ProgramData::battery.capacity;
+    tau /= cells;
+    uint32_t m = dSoc;
+    m *= 36;
+    uint32_t div = ANALOG_VOLT(0.100);
+    div *= SOC_FULL;
+    div *= 10;
+    //multiply first, divide last - lose precision only if it would overflow
+    while(m && tau > 0xffffffff / m) {
+        tau /= 10;
+        div /= 10;
     }
+    return tau * m / div;
 }
 
-uint32_t Monitor::getETATime()
+uint32_t Monitor::getChargeETATime()
 {
-    calculateDeltaProcentTimeSec();
-    uint8_t kx = 105;
-    if(!Monitor::isBalancePortConnected) {
-        //balancer not connected
-        kx=100;
+    AnalogInputs::ValueType Icc = Strategy::maxI;
+    if(Icc == 0)
+        return 0;
+
+    uint32_t tau = 0;
+    if(ProgramData::isLiXX() || ProgramData::isPb())
+        tau = getCVTimeConstant();
+
+    //CC phase: remaining charge without the CV tail charge (Icc*tau)
+    AnalogInputs::ValueType I = Icc;
+    uint32_t eta = 0;
+    if(AnalogInputs::getVbattery() + ANALOG_VOLT(0.020) < Strategy::endV || tau == 0) {
+        uint16_t C = StateOfCharge::getCharge();
+        if(C > ProgramData::battery.capacity) C = ProgramData::battery.capacity;
+        uint32_t Q = ProgramData::battery.capacity - C;
+        uint32_t Qcv = Icc;
+        Qcv *= tau;
+        Qcv /= 3600;
+        if(Q > Qcv) {
+            Q -= Qcv;
+            Q *= 3600;
+            eta = Q / Icc;
+        }
+    } else {
+        //CV phase
+        I = AnalogInputs::getIout();
     }
 
-    //if (getChargeProcent()==99) {return (0);} //no avail more calc (or call secondary calculator)
-    return (etaDeltaSec*(kx-procent_));
+    //CV tail: tau * ln(I/Imin), ln(4/3) = 0.2877
+    uint8_t n = 0;
+    if(Strategy::minI > 0) {
+        while(I > Strategy::minI && I >= 4) {
+            I -= I/4;
+            n++;
+        }
+    }
+    uint32_t tail = tau * n;
+    tail /= 10;
+    tail *= 2877;
+    tail /= 1000;
+    eta += tail;
+
+    //balancing runs parallel to charging
+    if(Strategy::doBalance) {
+        uint32_t bal = Balancer::getBalanceTimeEstimate();
+        if(bal > eta) eta = bal;
+    }
+    return eta;
+}
+
+uint32_t Monitor::getDischargeETATime()
+{
+    AnalogInputs::ValueType I = Strategy::maxI;
+    uint16_t cells = ProgramData::battery.cells;
+    if(I == 0 || cells == 0)
+        return 0;
+
+    uint16_t socEnd = StateOfCharge::getSOC(Strategy::endV / cells);
+    uint32_t Qend = ProgramData::battery.capacity;
+    Qend *= socEnd;
+    Qend /= SOC_FULL;
+
+    uint32_t Q = StateOfCharge::getCharge();
+    if(Q <= Qend)
+        return 0;
+    Q -= Qend;
+    Q *= 3600;
+    return Q / I;
+}
+
+uint32_t Monitor::getETATime()
+{
+    if(SMPS::isPowerOn())
+        return getChargeETATime();
+    if(Discharger::isPowerOn())
+        return getDischargeETATime();
+    return 0;
 }
 
 uint32_t Monitor::getTimeSec()
@@ -106,46 +210,81 @@ uint16_t Monitor::getTotalChargeDischargeTimeMin() {
 
 
 uint8_t Monitor::getChargeProcent() {
-    uint16_t v1,v2, v;
-    v2 = ProgramData::getVoltage(ProgramData::VCharged);
-    v1 = ProgramData::getVoltage(ProgramData::VvalidEmpty);
-    v =  AnalogInputs::getRealValue(AnalogInputs::VoutBalancer);
-
-    if(v >= v2) return 99;
-    if(v <= v1) return 0;
-    v-=v1;
-    v2-=v1;
-    v2/=100;
-    v=  v/v2;
-    if(v > 99) v=99; //not 101% with isCharge
-    return v;
+    return StateOfCharge::getProcent();
+}
+
+#ifdef MONITOR_T_INTERNAL_FAN
+//PI controller on Tintern (setpoint: fanTempOn - TempDifference,
+//full proportional output at fanTempOn) + discharge power feed forward
+uint8_t Monitor::calculateFanOutput()
+{
+    uint16_t now = Time::getMilisecondsU16();
+    if(Time::diffU16(fanLastUpdate_, now) >= FAN_UPDATE_PERIOD) {
+        fanLastUpdate_ = now;
+        int32_t e = AnalogInputs::getRealValue(AnalogInputs::Tintern);
+        e -= settings.fanTempOn - Settings::TempDifference;
+
+        int32_t i = e;
+        i *= FAN_MAX_OUTPUT << 4;
+        i /= Settings::TempDifference * FAN_INTEGRAL_TIME;
+        i += fanIntegral_;
+        if(i < 0) i = 0;
+        if(i > FAN_MAX_OUTPUT << 4) i = FAN_MAX_OUTPUT << 4;
+        fanIntegral_ = i;
+    }
+
+    int32_t e = AnalogInputs::getRealValue(AnalogInputs::Tintern);
+    e -= settings.fanTempOn - Settings::TempDifference;
+
+    int32_t out = e;
+    out *= FAN_MAX_OUTPUT;
+    out /= Settings::TempDifference;
+    out += fanIntegral_ >> 4;
+
+    if(Discharger::isWorking() && e > -int32_t(Settings::TempDifference)) {
+        //the discharger heats the heatsink with the whole output power
+        int32_t ff = AnalogInputs::getRealValue(AnalogInputs::Pout);
+        ff *= FAN_MAX_OUTPUT/2;
+        ff /= MAX_DISCHARGE_P;
+        out += ff;
+    }
+
+    if(out < FAN_MIN_OUTPUT) return 0;
+    if(out > FAN_MAX_OUTPUT) return FAN_MAX_OUTPUT;
+    return out;
+}
+#endif
+
+void Monitor::doInterrupt()
+{
+#ifdef MONITOR_T_INTERNAL_FAN
+    static uint8_t step = 0;
+    if(++step >= FAN_PWM_STEPS)
+        step = 0;
+
+    bool fan = fanDuty_ > step;
+    if(fan != fanState_) {
+        fanState_ = fan;
+        hardware::setFan(fan);
+    }
+#endif
 }
 
 void Monitor::doIdle()
 {
 #ifdef MONITOR_T_INTERNAL_FAN
-    bool fan;
+    uint8_t fan;
     if(settings.fanOn == Settings::FanAlways) {
-        fan = true;
+        fan = FAN_MAX_OUTPUT;
     } else if (settings.fanOn == Settings::FanDisabled
                || (settings.fanOn == Settings::FanProgramTemperature && on_ == false)) {
-        fan = false;
+        fan = 0;
     } else if (settings.fanOn == Settings::FanProgram) {
-        fan = on_;
-    } else if ((settings.fanOn == Settings::FanProgramTemperature && on_ == true)
-               || settings.fanOn == Settings::FanTemperature) {
-        AnalogInputs::ValueType t = AnalogInputs::getRealValue(AnalogInputs::Tintern);
-
-        if (t < settings.fanTempOn - Settings::TempDifference) {
-            fan = false;
-        } else if (t > settings.fanTempOn) {
-            fan = true;
-        } else {
-            // don't update fan (hysteresis)
-            return;
-        }
+        fan = on_ ? FAN_MAX_OUTPUT : 0;
+    } else {
+        fan = calculateFanOutput();
     }
-    hardware::setFan(fan);
+    fanDuty_ = (uint16_t(fan) * FAN_PWM_STEPS + FAN_MAX_OUTPUT/2) / FAN_MAX_OUTPUT;
 #endif
 }
 
@@ -180,9 +319,8 @@ void Monitor::powerOn()
 
 void Monitor::resetAccumulatedMeasurements()
 {
-    procent_ = getChargeProcent();
-    etaStartTimeCalc = 0;
-    etaDeltaSec = 0;
+    StateOfCharge::reset();
+    socMeasurement_ = AnalogInputs::getFullMeasurementCount();
 
     totalBalanceTime_ = 0;
     totalChargDischargeTime_ = 0;
@@ -210,6 +348,11 @@ Strategy::statusType Monitor::run()
     if(!on_) {
         return Strategy::RUNNING;
     }
+    if(socMeasurement_ != AnalogInputs::getFullMeasurementCount()) {
+        socMeasurement_ = AnalogInputs::getFullMeasurementCount();
+        StateOfCharge::update();
+        CycleHistory::update();
+    }
 #ifdef ENABLE_T_INTERNAL
     AnalogInputs::ValueType t = AnalogInputs::getRealValue(AnalogInputs::Tintern);
 
@@ -248,7 +391,7 @@ Strategy::statusType Monitor::run()
         return Strategy::ERROR;
     }
 
-    AnalogInputs::ValueType c = AnalogInputs::getRealValue(AnalogInputs::Cout);
+    AnalogInputs::WideValueType c = AnalogInputs::getWideRealValue(AnalogInputs::Cout);
     AnalogInputs::ValueType c_limit  = ProgramData::getCapacityLimit();
     if(c_limit != ANALOG_MAX_CHARGE && c_limit <= c) {
         Program::stopReason = string_capacityLimit;
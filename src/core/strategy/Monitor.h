@@ -24,12 +24,13 @@
 #define MONITOR_EXTERNAL_ERROR_BATTERY_DISCONNECTED         1
 
 namespace Monitor {
-    extern uint32_t etaDeltaSec;
     extern bool isBalancePortConnected;
     extern volatile uint8_t i_externalError;
 
     Strategy::statusType run();
     void doIdle();
+    //called from the timer interrupt
+    void doInterrupt();
     void powerOn();
     void powerOff();
 
@@ -15,10 +15,13 @@
     You should have received a copy of the GNU General Public License
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
+#define __STDC_LIMIT_MACROS
 #include "Hardware.h"
 #include "SMPS.h"
 #include "Program.h"
 #include "Settings.h"
+#include "memory.h"
+#include "Utils.h"
 
 #ifndef SMPS_MAX_CURRENT_CHANGE
 #define SMPS_MAX_CURRENT_CHANGE     ANALOG_AMP(0.200)
@@ -26,6 +29,15 @@
 
 #define SMPS_MAX_CURRENT_CHANGE_dM  ((AnalogInputs::ValueType)(SMPS_MAX_CURRENT_CHANGE*0.7))
 
+//converter efficiency [%] at 0, 1/4, 2/4, 3/4 and 4/4 of MAX_CHARGE_P
+//(output power), can be overridden in HardwareConfig.h
+#ifndef SMPS_EFFICIENCY_MAP
+#define SMPS_EFFICIENCY_MAP         75, 85, 88, 87, 85
+#endif
+
+//keep Vin above settings.inputVoltageLow + margin
+#define SMPS_INPUT_VOLTAGE_MARGIN   ANALOG_VOLT(0.500)
+
 namespace SMPS {
     bool on_ = false;
     uint16_t value_;
@@ -38,6 +50,92 @@ namespace SMPS {
 
     void setValue(uint16_t value);
 
+#ifdef ENABLE_SMPS_INPUT_POWER_LIMIT
+    const uint8_t efficiencyMap[] PROGMEM = { SMPS_EFFICIENCY_MAP };
+
+    //input power supply model: Vin = Vin0 - Rin * Iin
+    AnalogInputs::ValueType Vin0_;
+    uint16_t Rin_; //mOhm
+
+    //P - output power
+    uint8_t getEfficiency(AnalogInputs::ValueType P)
+    {
+        const uint8_t n = sizeOfArray(efficiencyMap) - 1;
+        uint32_t x = P;
+        x *= n;
+        uint8_t i = x / MAX_CHARGE_P;
+        if(i >= n)
+            return pgm::read(&efficiencyMap[n]);
+
+        int16_t e0 = pgm::read(&efficiencyMap[i]);
+        int16_t e1 = pgm::read(&efficiencyMap[i+1]);
+        int32_t e = e1 - e0;
+        e *= x % MAX_CHARGE_P;
+        e /= MAX_CHARGE_P;
+        return e0 + e;
+    }
+
+    void updateInputModel()
+    {
+        AnalogInputs::ValueType Vin = AnalogInputs::getRealValue(AnalogInputs::Vin);
+        if(!isWorking()) {
+            Vin0_ = Vin;
+            return;
+        }
+        AnalogInputs::ValueType P = AnalogInputs::getRealValue(AnalogInputs::Pout);
+        if(Vin == 0 || P == 0 || Vin >= Vin0_)
+            return;
+
+        //Iin[mA] = Pin[0.01W] * 10000 / Vin[mV]
+        uint32_t Iin = P;
+        Iin *= 100;
+        Iin /= getEfficiency(P);
+        Iin *= 10000;
+        Iin /= Vin;
+        if(Iin < ANALOG_AMP(1.000))
+            return;
+
+        uint32_t R = Vin0_ - Vin;
+        R *= 1000;
+        R /= Iin;
+        if(R > UINT16_MAX) R = UINT16_MAX;
+        int32_t dR = R;
+        dR -= Rin_;
+        Rin_ += dR / 4;
+    }
+
+    //output power which keeps Vin above the input voltage limit
+    AnalogInputs::ValueType getInputMaxP()
+    {
+        updateInputModel();
+
+        AnalogInputs::ValueType Vlim = settings.inputVoltageLow + SMPS_INPUT_VOLTAGE_MARGIN;
+        if(Rin_ == 0)
+            return settings.maxPc;
+        if(Vin0_ <= Vlim)
+            return 0;
+
+        //Pin[0.01W] = Vlim[mV] * Iin_max[mA] / 10000
+        uint32_t P = Vin0_ - Vlim;
+        P *= 1000;
+        P /= Rin_;
+        if(P > UINT16_MAX)
+            return settings.maxPc;
+        P *= Vlim;
+        P /= 10000;
+
+        //Pout = Pin * efficiency(Pout): the first guess
+        //looks up the input power, one iteration corrects it
+        uint32_t Pin = P;
+        for(uint8_t i = 0; i < 2; i++) {
+            if(P > MAX_CHARGE_P) P = MAX_CHARGE_P;
+            P = Pin * getEfficiency(P) / 100;
+        }
+        if(P > settings.maxPc) P = settings.maxPc;
+        return P;
+    }
+#endif
+
     AnalogInputs::ValueType getMaxIout()
     {
         AnalogInputs::ValueType v = AnalogInputs::getVout();
@@ -45,19 +143,12 @@ namespace SMPS {
             v = 1;
         }
 
-#ifdef ENABLE_DYNAMIC_MAX_POWER
-        AnalogInputs::ValueType v_in_10 = AnalogInputs::getRealValue(AnalogInputs::Vin);
-        if(v_in_10 > ANALOG_VOLT(10)) {
-            v_in_10 -= ANALOG_VOLT(10);
-            if(v > v_in_10) {
-                v -= v_in_10;
-            } else {
-                v = 1;
-            }
-        }
+        AnalogInputs::ValueType P = settings.maxPc;
+#ifdef ENABLE_SMPS_INPUT_POWER_LIMIT
+        P = getInputMaxP();
 #endif
 
-        AnalogInputs::ValueType i = AnalogInputs::evalI(settings.maxPc, v);
+        AnalogInputs::ValueType i = AnalogInputs::evalI(P, v);
         if(i > settings.maxIc)
             i = settings.maxIc;
         return i;
@@ -111,6 +202,10 @@ void SMPS::powerOn()
     value_ = 0;
     IoutSet_ = 0;
     setValue(0);
+#ifdef ENABLE_SMPS_INPUT_POWER_LIMIT
+    Vin0_ = AnalogInputs::getRealValue(AnalogInputs::Vin);
+    Rin_ = 0;
+#endif
     hardware::setChargerOutput(true);
     on_ = true;
 }
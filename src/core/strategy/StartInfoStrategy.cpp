@@ -23,6 +23,7 @@
 #include "Settings.h"
 #include "Program.h"
 #include "Utils.h"
+#include "StateOfCharge.h"
 
 namespace StartInfoStrategy {
     uint8_t ok_;
@@ -54,6 +55,9 @@ Strategy::statusType StartInfoStrategy::doStrategy()
     bool cell_nr, v_balance, v_out, balance;
     uint8_t is_cells, should_be_cells;
 
+    //no current flows: the start info screen shows the open circuit voltage estimate
+    StateOfCharge::reset();
+
     cell_nr = v_balance = false;
     v_out = ! AnalogInputs::isConnected(AnalogInputs::Vout);
 
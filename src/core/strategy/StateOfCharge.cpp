@@ -0,0 +1,169 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "StateOfCharge.h"
+#include "ProgramData.h"
+#include "TheveninMethod.h"
+#include "SMPS.h"
+#include "Discharger.h"
+#include "memory.h"
+#include "Utils.h"
+
+//state of charge correction: SOC += (SOC_ocv - SOC) / SOC_CORRECTION
+#define SOC_CORRECTION          64
+#define SOC_REST_CORRECTION     4
+
+namespace StateOfCharge {
+
+    //open circuit voltage per cell at 0%, 10%, ..., 100%
+    //LiXX, Pb, NiZn end points: docs/battery_valid_voltage_vs_percentage.txt
+    //a zero table: linear between "valid empty" and "charged" voltage
+    const AnalogInputs::ValueType ocvTable[][SOC_TABLE_SIZE] PROGMEM = {
+/*None*/    { 0 },
+/*NiCd*/    { ANALOG_VOLT(1.000), ANALOG_VOLT(1.150), ANALOG_VOLT(1.200), ANALOG_VOLT(1.220), ANALOG_VOLT(1.235), ANALOG_VOLT(1.250),
+              ANALOG_VOLT(1.265), ANALOG_VOLT(1.280), ANALOG_VOLT(1.300), ANALOG_VOLT(1.330), ANALOG_VOLT(1.400)},
+/*NiMH*/    { ANALOG_VOLT(1.000), ANALOG_VOLT(1.150), ANALOG_VOLT(1.200), ANALOG_VOLT(1.220), ANALOG_VOLT(1.235), ANALOG_VOLT(1.250),
+              ANALOG_VOLT(1.265), ANALOG_VOLT(1.280), ANALOG_VOLT(1.300), ANALOG_VOLT(1.330), ANALOG_VOLT(1.400)},
+/*Pb*/      { ANALOG_VOLT(1.900), ANALOG_VOLT(1.920), ANALOG_VOLT(1.940), ANALOG_VOLT(1.960), ANALOG_VOLT(1.980), ANALOG_VOLT(2.000),
+              ANALOG_VOLT(2.020), ANALOG_VOLT(2.040), ANALOG_VOLT(2.060), ANALOG_VOLT(2.080), ANALOG_VOLT(2.100)},
+/*Life*/    { ANALOG_VOLT(3.000), ANALOG_VOLT(3.200), ANALOG_VOLT(3.250), ANALOG_VOLT(3.280), ANALOG_VOLT(3.300), ANALOG_VOLT(3.310),
+              ANALOG_VOLT(3.320), ANALOG_VOLT(3.330), ANALOG_VOLT(3.340), ANALOG_VOLT(3.360), ANALOG_VOLT(3.600)},
+/*Lilo*/    { ANALOG_VOLT(3.500), ANALOG_VOLT(3.600), ANALOG_VOLT(3.650), ANALOG_VOLT(3.700), ANALOG_VOLT(3.740), ANALOG_VOLT(3.780),
+              ANALOG_VOLT(3.820), ANALOG_VOLT(3.870), ANALOG_VOLT(3.930), ANALOG_VOLT(4.000), ANALOG_VOLT(4.100)},
+/*LiPo*/    { ANALOG_VOLT(3.209), ANALOG_VOLT(3.680), ANALOG_VOLT(3.740), ANALOG_VOLT(3.770), ANALOG_VOLT(3.790), ANALOG_VOLT(3.820),
+              ANALOG_VOLT(3.870), ANALOG_VOLT(3.920), ANALOG_VOLT(3.980), ANALOG_VOLT(4.060), ANALOG_VOLT(4.199)},
+/*Li430*/   { ANALOG_VOLT(3.209), ANALOG_VOLT(3.690), ANALOG_VOLT(3.750), ANALOG_VOLT(3.790), ANALOG_VOLT(3.820), ANALOG_VOLT(3.860),
+              ANALOG_VOLT(3.920), ANALOG_VOLT(3.990), ANALOG_VOLT(4.070), ANALOG_VOLT(4.160), ANALOG_VOLT(4.299)},
+/*Li435*/   { ANALOG_VOLT(3.209), ANALOG_VOLT(3.700), ANALOG_VOLT(3.760), ANALOG_VOLT(3.800), ANALOG_VOLT(3.830), ANALOG_VOLT(3.880),
+              ANALOG_VOLT(3.940), ANALOG_VOLT(4.010), ANALOG_VOLT(4.100), ANALOG_VOLT(4.200), ANALOG_VOLT(4.349)},
+/*NiZn*/    { ANALOG_VOLT(1.500), ANALOG_VOLT(1.700), ANALOG_VOLT(1.740), ANALOG_VOLT(1.760), ANALOG_VOLT(1.780), ANALOG_VOLT(1.800),
+              ANALOG_VOLT(1.820), ANALOG_VOLT(1.840), ANALOG_VOLT(1.860), ANALOG_VOLT(1.880), ANALOG_VOLT(1.900)},
+/*Unknown*/ { 0 },
+/*LED*/     { 0 },
+    };
+
+    //charge stored in the battery
+    int32_t Q_;
+    AnalogInputs::WideValueType lastCout_;
+
+    int32_t getQ(uint16_t soc) {
+        int32_t q = ProgramData::battery.capacity;
+        q *= soc;
+        q /= SOC_FULL;
+        return q;
+    }
+
+    int32_t getOCVQ() { return getQ(getSOC(getOCV())); }
+
+    bool isAtRest() { return !SMPS::isWorking() && !Discharger::isWorking(); }
+
+} // namespace StateOfCharge
+
+
+uint16_t StateOfCharge::getSOC(AnalogInputs::ValueType v)
+{
+    STATIC_ASSERT(sizeOfArray(ocvTable) == ProgramData::LAST_BATTERY_TYPE);
+    const AnalogInputs::ValueType * table = ocvTable[ProgramData::battery.type];
+    AnalogInputs::ValueType v0 = pgm::read(&table[0]);
+    uint32_t r;
+
+    if(v0 == 0) {
+        AnalogInputs::ValueType v1;
+        v0 = ProgramData::getDefaultVoltagePerCell(ProgramData::VvalidEmpty);
+        v1 = ProgramData::getDefaultVoltagePerCell(ProgramData::VCharged);
+        if(v <= v0) return 0;
+        if(v >= v1) return SOC_FULL;
+        r = v - v0;
+        r *= SOC_FULL;
+        r /= v1 - v0;
+        return r;
+    }
+
+    if(v <= v0) return 0;
+    for(uint8_t i = 1; i < SOC_TABLE_SIZE; i++) {
+        AnalogInputs::ValueType v1 = pgm::read(&table[i]);
+        if(v < v1) {
+            r = v - v0;
+            r *= SOC_FULL/(SOC_TABLE_SIZE - 1);
+            r /= v1 - v0;
+            return r + (i - 1) * (SOC_FULL/(SOC_TABLE_SIZE - 1));
+        }
+        v0 = v1;
+    }
+    return SOC_FULL;
+}
+
+AnalogInputs::ValueType StateOfCharge::getOCV()
+{
+    int32_t v = AnalogInputs::getVbattery();
+    if(TheveninMethod::isBattRthMeasured()) {
+        int32_t IR = AnalogInputs::getIout();
+        IR *= TheveninMethod::getReadableBattRth();
+        IR /= ANALOG_OHM(1.000);
+        if(SMPS::isPowerOn()) v -= IR;
+        else if(Discharger::isPowerOn()) v += IR;
+    }
+    uint16_t cells = ProgramData::battery.cells;
+    if(cells == 0 || v < 0)
+        return 0;
+    return v / cells;
+}
+
+void StateOfCharge::reset()
+{
+    lastCout_ = AnalogInputs::getWideRealValue(AnalogInputs::Cout);
+    Q_ = getOCVQ();
+}
+
+void StateOfCharge::update()
+{
+    //coulomb counting
+    AnalogInputs::WideValueType C = AnalogInputs::getWideRealValue(AnalogInputs::Cout);
+    if(C < lastCout_)
+        lastCout_ = 0;
+    int32_t dC = C - lastCout_;
+    lastCout_ = C;
+    if(SMPS::isPowerOn()) Q_ += dC;
+    else if(Discharger::isPowerOn()) Q_ -= dC;
+
+    //slow correction with the open circuit voltage
+    int32_t dQ = getOCVQ() - Q_;
+    if(isAtRest()) dQ /= SOC_REST_CORRECTION;
+    else dQ /= SOC_CORRECTION;
+    Q_ += dQ;
+
+    int32_t capacity = ProgramData::battery.capacity;
+    if(Q_ > capacity) Q_ = capacity;
+    if(Q_ < 0) Q_ = 0;
+}
+
+AnalogInputs::ValueType StateOfCharge::getCharge()
+{
+    return Q_;
+}
+
+uint8_t StateOfCharge::getProcent()
+{
+    uint16_t capacity = ProgramData::battery.capacity;
+    if(capacity == 0)
+        return 0;
+    uint32_t p = Q_;
+    p *= 100;
+    p /= capacity;
+    if(p > 99) p = 99; //not 101% with isCharge
+    return p;
+}
@@ -0,0 +1,41 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2013  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef STATEOFCHARGE_H_
+#define STATEOFCHARGE_H_
+
+#include "AnalogInputs.h"
+
+#define SOC_TABLE_SIZE 11  //0%, 10%, ..., 100%
+#define SOC_FULL 10000     //state of charge in 0.01%
+
+namespace StateOfCharge {
+
+    void reset();
+    void update();
+
+    uint8_t getProcent();
+    //charge stored in the battery
+    AnalogInputs::ValueType getCharge();
+
+    //presumed open circuit voltage per cell (IR compensated)
+    AnalogInputs::ValueType getOCV();
+    //open circuit voltage per cell -> state of charge (0..SOC_FULL)
+    uint16_t getSOC(AnalogInputs::ValueType Vcell);
+};
+
+#endif /* STATEOFCHARGE_H_ */
@@ -23,6 +23,8 @@
 #include "Monitor.h"
 #include "AnalogInputs.h"
 #include "Screen.h"
+#include "Profiler.h"
+#include "LoopStats.h"
 
 #define STRATEGY_DISABLE_OUTPUT_AFTER_SECONDS (3*60)
 
@@ -94,7 +96,10 @@ namespace Strategy {
 
     Strategy::statusType strategyDoStrategy() {
         Strategy::statusType (*doStrategy)() = pgm::read(&strategy->doStrategy);
-        return doStrategy();
+        PROFILER_BEGIN(start);
+        Strategy::statusType status = doStrategy();
+        PROFILER_END(DoStrategy, start);
+        return status;
     }
 
 
@@ -119,8 +124,15 @@ namespace Strategy {
         uint16_t newMesurmentData = 0;
         Strategy::statusType status = Strategy::RUNNING;
         strategyPowerOn();
+#ifdef ENABLE_LOOP_STATS
+        LoopStats::reset();
+#endif
         do {
-            Screen::keyboardButton =  Keyboard::getPressedWithDelay();
+#ifdef ENABLE_LOOP_STATS
+            LoopStats::loop();
+#endif
+            //wake up on new measurements - the strategy runs right after them
+            Screen::keyboardButton =  Keyboard::getPressedWithDelay(true);
             Screen::doStrategy();
 
             if(run) {
@@ -130,6 +142,9 @@ namespace Strategy {
                 if(run && newMesurmentData != AnalogInputs::getFullMeasurementCount()) {
                     newMesurmentData = AnalogInputs::getFullMeasurementCount();
                     status = strategyDoStrategy();
+#ifdef ENABLE_LOOP_STATS
+                    LoopStats::strategyRun();
+#endif
                     run = analizeStrategyStatus(status);
                 }
             }
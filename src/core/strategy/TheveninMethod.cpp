@@ -43,6 +43,7 @@ namespace TheveninMethod {
     Thevenin tVout_;
     Thevenin tBal_[MAX_BALANCE_CELLS];
     uint8_t fullCount_;
+    bool charge_;
 
     uint16_t lastBallancingEnded_;
     Strategy::statusType bstatus_;
@@ -65,10 +66,22 @@ namespace TheveninMethod {
         return I < Strategy::minI;
     }
     void storeI(AnalogInputs::ValueType I);
+
+    bool isCellsRthMeasured()
+    {
+        for(uint8_t c = 0; c < MAX_BALANCE_CELLS; c++) {
+            if(AnalogInputs::connectedBalancePortCells & (1<<c)) {
+                if(tBal_[c].ILastDiff_ == 0)
+                    return false;
+            }
+        }
+        return true;
+    }
 }
 
 AnalogInputs::ValueType TheveninMethod::getReadableRthCell(uint8_t cell) { return tBal_[cell].Rth.getReadableRth(); }
 AnalogInputs::ValueType TheveninMethod::getReadableBattRth()             { return tVout_.Rth.getReadableRth(); }
+bool TheveninMethod::isBattRthMeasured()                                 { return tVout_.ILastDiff_ != 0; }
 AnalogInputs::ValueType TheveninMethod::getReadableWiresRth()
 {
     Resistance R;
@@ -79,9 +92,22 @@ AnalogInputs::ValueType TheveninMethod::getReadableWiresRth()
 
 }
 
+AnalogInputs::ValueType TheveninMethod::getCellVRth(uint8_t cell, AnalogInputs::ValueType I)
+{
+    const Resistance &R = tBal_[cell].Rth;
+    if(R.iV <= 0 || R.uI == 0)
+        return 0;
+    uint32_t VRth = I;
+    VRth *= R.iV;
+    VRth /= R.uI;
+    if(VRth > UINT16_MAX) return UINT16_MAX;
+    return VRth;
+}
+
 void TheveninMethod::initialize(bool charge)
 {
     bstatus_ = Strategy::COMPLETE;
+    charge_ = charge;
 
     AnalogInputs::ValueType Vout = AnalogInputs::getVbattery();
     tVout_.init(Vout, Strategy::endV, Strategy::minI, charge);
@@ -110,6 +136,10 @@ bool TheveninMethod::balance_isComplete(bool isEndVout, AnalogInputs::ValueType
             Balancer::endBalancing();
             state_ = ConstantCurrent;
         }
+        //balance during constant current charge only when the cell
+        //resistances are known (measured at least once)
+        Balancer::chargeBalancing = charge_ && state_ == ConstantCurrentBalancing && isCellsRthMeasured();
+
         if(state_ == ConstantCurrentBalancing || state_ == ConstantVoltageBalancing) {
             if(I > max(BALANCER_I, Strategy::minI))
                 Balancer::done = false;
@@ -144,7 +174,8 @@ AnalogInputs::ValueType TheveninMethod::calculateNewI(bool isEndVout, AnalogInpu
 
     //update only when we are not balancing:
     //- on PowerB6 Balancer::getPresumedV is not stable enough
-    updateI = updateI && !Balancer::isWorking();
+    //during constant current charge the cell voltages are Rth compensated
+    updateI = updateI && (Balancer::chargeBalancing || !Balancer::isWorking());
 
     if(updateI) {
 
@@ -29,8 +29,11 @@ namespace TheveninMethod {
     void calculateRthVth(AnalogInputs::ValueType I);
     AnalogInputs::ValueType calculateNewI(bool isEndVout, AnalogInputs::ValueType I);
 
+    AnalogInputs::ValueType getCellVRth(uint8_t cell, AnalogInputs::ValueType I);
+
     AnalogInputs::ValueType getReadableRthCell(uint8_t cell);
     AnalogInputs::ValueType getReadableBattRth();
+    bool isBattRthMeasured();
     AnalogInputs::ValueType getReadableWiresRth();
 };
 
@@ -0,0 +1,51 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "Dictionary.h"
+#include "memory.h"
+#include "Hardware.h"
+
+#ifdef ENABLE_STRINGS_DICTIONARY
+
+char Dictionary::read(Reader &r)
+{
+    if(r.word) {
+        char c = pgm::read(r.word++);
+        if(c) return c;
+        r.word = NULL;
+    }
+    char c = pgm::read(r.str++);
+    uint8_t token = (uint8_t) c - DICTIONARY_FIRST_TOKEN;
+    if(token < DICTIONARY_TOKENS) {
+        r.word = &words[pgm::read(&wordIndex[token])];
+        c = pgm::read(r.word++);
+    }
+    return c;
+}
+
+uint8_t Dictionary::strlen(const char *str)
+{
+    Reader r;
+    uint8_t n = 0;
+    begin(r, str);
+    while(read(r)) {
+        n++;
+    }
+    return n;
+}
+
+#endif //ENABLE_STRINGS_DICTIONARY
@@ -0,0 +1,51 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef DICTIONARY_H_
+#define DICTIONARY_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include "HardwareConfig.h"
+#include "memory.h"
+
+/*
+ * streaming reader of the PROGMEM strings,
+ * bytes DICTIONARY_FIRST_TOKEN.. are replaced by the dictionary words
+ */
+#define DICTIONARY_FIRST_TOKEN  0x80
+#define DICTIONARY_TOKENS       32
+
+namespace Dictionary {
+    struct Reader {
+        const char * str;
+        const char * word;
+    };
+
+    inline void begin(Reader &r, const char *str) { r.str = str; r.word = NULL; }
+#ifdef ENABLE_STRINGS_DICTIONARY
+    //returns 0 at the end of the string
+    char read(Reader &r);
+    uint8_t strlen(const char *str);
+#else
+    //plain strings: no decoder code
+    inline char read(Reader &r) { return pgm::read(r.str++); }
+    inline uint8_t strlen(const char *str) { return pgm::strlen(str); }
+#endif
+};
+
+#endif /* DICTIONARY_H_ */
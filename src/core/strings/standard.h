@@ -62,9 +62,27 @@ namespace ProgramMenus {
     STRING(storageAndBalance,   "storage+balanc");
     STRING(dcCycle,             "D>C format");
     STRING(capacityCheck,       "capacity check");
+    STRING(capacityEstimate,    "cap. estimate");
+    STRING(IRTest,              "IR test");
+    STRING(sequence,            "sequence");
     STRING(editBattery,         "edit battery");
 }
 
+namespace SequenceMenu {
+    STRING(end,         "end");
+    STRING(rest,        "rest");
+    STRING(repeat,      "repeat");
+    STRING(default,     "def.");
+
+    //menu
+    STRING(step,        "step:");
+    STRING(rate,        "I:");
+    STRING(endSOC,      "end SOC:");
+    STRING(time,        "time:");
+    STRING(gotoStep,    "goto step:");
+    STRING(count,       "count:");
+}
+
 namespace options {
     STRING(options,         "options");
     STRING(settings,        "settings");
@@ -0,0 +1,299 @@
+/*
+    cheali-charger - open source firmware for a variety of LiPo chargers
+    Copyright (C) 2014  Paweł Stawicki. All right reserved.
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+/*
+ * generated by utils/stringsDictionary/generate.py from standard.h - do not edit
+ */
+#ifndef STRINGS_DICTIONARY_H_
+#define STRINGS_DICTIONARY_H_
+
+#include "strings_common.h"
+
+namespace AnalogInputs {
+    //units
+    STRING(A,           "A");
+    STRING(V,           "V");
+    STRING(W,           "W");
+    STRING(Wh,          "Wh");
+    STRING(C,           "C");
+    STRING(Ah,          "Ah");
+    STRING(Ohm,         "\xf4");
+    STRING(procent,     "%");
+    STRING(C_m,         "C/m");
+    STRING(minutes,     "m");
+    STRING(unsigned,    "");
+    STRING(unknown,     "U");
+
+    STRING(yes,         "yes");
+    STRING(no,          " no");
+    STRING_SIZE_DICTIONARY(unlimited,  "no\x8c", 8);
+}
+
+namespace Monitor {
+    STRING(batteryDisconnected,         "\x82" " \x85" "c.");
+    STRING(internalTemperatureToHigh,   "\x83" "t.\x84" ".\x87");
+    STRING(balancePortDisconnected,     "\x81" "\x94" " \x85" "c.");
+    STRING(outputCurrentToHigh,         "HW \x9c" "ilu\x91");
+
+    STRING(inputVoltageToLow,           "\x83" "pu\x8e" "V to low");
+    STRING(capacityLimit,               "\x8b" "\x87");
+    STRING(timeLimit,                   "\x92" " \x8c");
+    STRING(externalTemperatureCutOff,   "\x88" ".\x84" ".\x87");
+};
+
+namespace ProgramMenus {
+    STRING(charge,              "\x80");
+    STRING(chargeAndBalance,    "\x80" "+\x81" "e");
+    STRING(balance,             "\x81" "e");
+    STRING(discharge,           "\x85" "\x80");
+    STRING(fastCharge,          "\x9c" "\x8a" " \x80");
+    STRING(storage,             "\x8a" "\x9f" "\x98");
+    STRING(storageAndBalance,   "\x8a" "\x9f" "\x98" "+\x81");
+    STRING(dcCycle,             "D>C f\x9f" "mat");
+    STRING(capacityCheck,       "\x8b" "check");
+    STRING(capacityEstimate,    "cap\x97" "e\x8a" "imate");
+    STRING(IRTest,              "IR te\x8a");
+    STRING(sequence,            "\x96" "qu\x9a" "ce");
+    STRING(editBattery,         "edi\x8e" "\x82");
+}
+
+namespace SequenceMenu {
+    STRING(end,         "\x9a" "d");
+    STRING(rest,        "\x91" "\x8a");
+    STRING(repeat,      "\x91" "peat");
+    STRING(default,     "def.");
+
+    //menu
+    STRING(step,        "\x8a" "\x9b");
+    STRING(rate,        "I:");
+    STRING(endSOC,      "\x9a" "d SOC:");
+    STRING(time,        "\x92" ":");
+    STRING(gotoStep,    "goto \x8a" "\x9b");
+    STRING(count,       "count:");
+}
+
+namespace options {
+    STRING(options,         "opti\x9e" "s");
+    STRING(settings,        "\x96" "tt\x83" "gs");
+    STRING(calibrate,       "c\x93" "ibrate");
+    STRING(resetDefault,    "\x91" "\x96" "\x8e" "de\x9c" "ult");
+}
+
+namespace ProgramData {
+    STRING_SIZE_DICTIONARY(minutes,    "m\x83" ".", 5);
+
+    //battery types
+    STRING(battery_None,    "N\x9e" "e");
+    STRING(battery_Unknown, "Unkn");
+    STRING(battery_NiCd,    "NiCd");
+    STRING(battery_NiMH,    "NiMH");
+    STRING(battery_Pb,      "Pb  ");
+    STRING(battery_Life,    "Life");
+    STRING(battery_Lilo,    "Lilo");
+    STRING(battery_Lipo,    "Lipo");
+    STRING(battery_Li430,   "L430");
+    STRING(battery_Li435,   "L435");
+    STRING(battery_NiZn,    "NiZn");
+    STRING(battery_LED,     "LED");
+}
+
+namespace SettingsMenu {
+    //settings menu
+    STRING(backlight,   "backlight:");
+    STRING(fanOn,       "\x9c" "n \x9e" ":");
+    STRING(fanTempOn,   "|\x9c" "\x9d" " \x9e" ":");
+    STRING(dischOff,    "\x85" "ch off:");
+    STRING(AudioBeep,   "be\x9b");
+    STRING(minIc,       "m\x83" " I\x8d");
+    STRING(maxIc,       "\x89" "I\x8d");
+    STRING(minId,       "m\x83" " \x8f");
+    STRING(maxId,       "\x89" "\x8f");
+    STRING(maxPc,       "\x89" "P\x8d");
+    STRING(maxPd,       "\x89" "Pd:");
+    STRING(inputLow,    "\x83" "pu\x8e" "low:");
+    STRING(adcNoise,    "adc noi\x96" ":");
+    STRING(UARTview,    "UART:");
+    STRING(UARTspeed,   "|speed:");
+    STRING(UARToutput,  "|output:");
+    STRING(MenuType,    "m\x9a" "u\x95");
+    STRING(MenuButtons, "butt\x9e" "\x95");
+    STRING(reset,       "\x91" "\x96" "t");
+
+    //UARToutput menu
+    STRING(temp,        "\x84");
+    STRING(separated,   "\x96" "par");
+    STRING(pin7,        "p\x83" "7");
+    STRING(pin38,       "p\x83" "38");
+
+    //UART view menu
+    STRING(disable,     "\x85" "abled");
+    STRING(normal,      "n\x9f" "m\x93");
+    STRING(debug,       "debug");
+    STRING(extDebug,    "\x88" "\x97" "deb");
+    STRING(extDebugAdc, "\x88" "\x97" "Adc");
+
+    //fanOn reason menu
+//  STRING(disable,     "disabled"); -- defined in UART view
+    STRING(always,      "\x93" "ways");
+    STRING(FanProgram,  "program");
+    STRING(temperature, "Temp\x94" "a");
+    STRING(tempProgram, "T-progr");
+
+    //MenuType
+    STRING(simple,      "simple");
+    STRING(advanced,    "advanced");
+
+    //MenuButtons
+    //STRING(normal,      "normal"); - defined in UART view
+    STRING(reversed,      "\x91" "v");
+
+}
+
+namespace ProgramDataMenu {
+    //menu
+    STRING(batteryType, "\x82" ":");
+    STRING(voltage,     "V:");
+    STRING(Vc_per_cell, "V\x8d");
+    STRING(Vs_per_cell, "V\x95");
+    STRING(Vd_per_cell, "Vd:");
+    STRING(Vcutoff,     "Vco:");
+    STRING(capacity,    "Cap:");
+    STRING(Ic,          "I\x8d");
+    STRING(minIc,       "m\x83" "I\x8d");
+    STRING(Id,          "\x8f");
+    STRING(minId,       "m\x83" "\x8f");
+    STRING(balancErr,   "b\x93" "\x97" "\x94" "r:");
+
+    STRING(enabledV,    "\x9a" "ab dV:");
+    STRING(deltaV,      "|dV:");
+    STRING(ignoreFirst, "|ignr fr\x8a" ":");
+
+    STRING(externT,     "\x88" "r\x9d" ":");
+    STRING(dTdt,        "|\x99" ":");
+    STRING(externTCO,   "|\x88" "r\x9d" "CO:");
+
+    STRING(timeLimit,   "\x92" ":");
+    STRING(capCoff,     "cap COff:");
+    STRING(DCcycles,    "D/C cycle\x95");
+    STRING(DCRestTime,  "D/C \x91" "\x8a" ":");
+    STRING(adaptiveDis, "adap\x8e" "\x85" ":");
+}
+
+namespace DeltaChargeStrategy {
+    STRING(batteryVoltageReachedUpperLimit,         "V \x8c");
+    STRING(batteryVoltageReachedDeltaVLimit,        "-dV");
+    STRING(externalTemperatureReachedDeltaTLimit,   "\x99");
+}
+
+namespace Calibration {
+    STRING(connect,     "\x90");
+    STRING(disconnect,  "\x85" "\x90");
+    STRING(battery,     "\x82" "!");
+    STRING(balancePort, "\x81" "e p\x9f" "t!");
+
+    //calibration main menu
+    STRING(voltage,             "volt\x98");
+    STRING(chargeCurrent,       "I \x80");
+    STRING(dischargeCurrent,    "I \x85" "\x80");
+    STRING(externalTemperature, "\x84" " \x88" "\x94" "n");
+    STRING(internalTemperature, "\x84" " \x83" "t\x94" "n");
+    STRING(expertVoltage,       "exp\x94" "\x8e" "DANGER!");
+
+
+    //calibration voltage menu
+    STRING(v_menu_input,    "V\x83" ":");
+    STRING(v_menu_cell1,    "\x86" "1:");
+    STRING(v_menu_cell2,    "\x86" "2:");
+    STRING(v_menu_cell3,    "\x86" "3:");
+    STRING(v_menu_cell4,    "\x86" "4:");
+    STRING(v_menu_cell5,    "\x86" "5:");
+    STRING(v_menu_cell6,    "\x86" "6:");
+    STRING(v_menu_cell7,    "\x86" "7:");
+    STRING(v_menu_cell8,    "\x86" "8:");
+#if MAX_BALANCE_CELLS > 6
+    STRING(v_menu_cellSum,  "V1-8:");
+#else
+    STRING(v_menu_cellSum,  "V1-6:");
+#endif
+    STRING(v_menu_output,   "Vout:");
+    STRING(menu_point,      "c\x93" "ib\x97" "p.:");
+
+    //calibration common current menu
+    STRING(i_menu_value,    "v\x93" "ue:");
+    STRING(i_menu_output,   "I:");
+    STRING(i_menu_expected, "Iexpe\x8d");
+
+
+    //calibration temperature select point menu
+    STRING(tp_menu_point0,  "po\x83" "\x8e" "1.");
+    STRING(tp_menu_point1,  "po\x83" "\x8e" "2.");
+
+    //calibration temperature menu
+    STRING(t_menu_temperature,  "\x84" ":");
+    STRING(t_menu_adc,          "ad\x8d");
+
+
+    //calibration expert voltage menu
+    STRING(ev_menu_cell0pin,        "\x86" "0p\x83" ":");
+    STRING(ev_menu_cell1pin,        "\x86" "1p\x83" ":");
+    STRING(ev_menu_cell2pin,        "\x86" "2p\x83" ":");
+    STRING(ev_menu_plusVoltagePin,  "Vplu\x95");
+    STRING(ev_menu_minusVoltagePin, "Vm\x83" "u\x95");
+}
+
+namespace Dictionary {
+    //strings: 1203 bytes, compressed: 856 bytes + dictionary: 175 bytes
+    DICTIONARY_WORDS(
+        "charge" "\0"
+        "balanc" "\0"
+        "battery" "\0"
+        "in" "\0"
+        "temp" "\0"
+        "dis" "\0"
+        "Vb" "\0"
+        "cutoff" "\0"
+        "ext" "\0"
+        "max " "\0"
+        "st" "\0"
+        "capacity " "\0"
+        "limit" "\0"
+        "c:" "\0"
+        "t " "\0"
+        "Id:" "\0"
+        "connect" "\0"
+        "re" "\0"
+        "time" "\0"
+        "al" "\0"
+        "er" "\0"
+        "s:" "\0"
+        "se" "\0"
+        ". " "\0"
+        "age" "\0"
+        "dT/dt" "\0"
+        "en" "\0"
+        "ep:" "\0"
+        "fa" "\0"
+        "n T" "\0"
+        "on" "\0"
+        "or" "\0"
+    );
+    DICTIONARY_INDEX(
+        0, 7, 14, 22, 25, 30, 34, 37, 44, 48, 53, 56, 66, 72, 75, 78, 82, 90, 93, 98, 101, 104, 107, 110, 113, 117, 123, 126, 130, 133, 137, 140
+    );
+}
+
+#endif /* STRINGS_DICTIONARY_H_ */
@@ -3,10 +3,22 @@
 set(CURRENT_DIR ${CMAKE_CURRENT_LIST_DIR})
 
 set(CORE_SOURCE
-    standard.h  strings_common.h  strings.cpp
+    standard.h  strings_common.h  strings.cpp  standard_dictionary.h  Dictionary.h  Dictionary.cpp
 )
 
-SET_SOURCE_FILES_PROPERTIES(${CURRENT_DIR}/strings.cpp PROPERTIES OBJECT_DEPENDS ${CURRENT_DIR}/standard.h)
+#standard_dictionary.h is generated from standard.h (and committed for the builds without python)
+set(DICTIONARY_GENERATOR ${CMAKE_SOURCE_DIR}/utils/stringsDictionary/generate.py)
+find_program(PYTHON_EXECUTABLE NAMES python3 python)
+if(PYTHON_EXECUTABLE)
+    add_custom_command(
+        OUTPUT ${CURRENT_DIR}/standard_dictionary.h
+        COMMAND ${PYTHON_EXECUTABLE} ${DICTIONARY_GENERATOR} ${CURRENT_DIR}/standard.h ${CURRENT_DIR}/standard_dictionary.h
+        DEPENDS ${CURRENT_DIR}/standard.h ${DICTIONARY_GENERATOR})
+elseif(${CURRENT_DIR}/standard.h IS_NEWER_THAN ${CURRENT_DIR}/standard_dictionary.h)
+    message(FATAL_ERROR "standard_dictionary.h is older than standard.h, run: ${DICTIONARY_GENERATOR} standard.h standard_dictionary.h")
+endif()
+
+SET_SOURCE_FILES_PROPERTIES(${CURRENT_DIR}/strings.cpp PROPERTIES OBJECT_DEPENDS "${CURRENT_DIR}/standard.h;${CURRENT_DIR}/standard_dictionary.h")
 
 CHEALI_ADD("CORE_SOURCE_FILES" "${CORE_SOURCE}")
 
@@ -23,9 +23,16 @@
 #ifdef STRINGS_CPP_
 #define STRING(name, value) STRING_CPP(name, value)
 #define STRING_SIZE(name, value) STRING_CPP(name, value)
+#define STRING_SIZE_DICTIONARY(name, value, size) STRING_CPP(name, value)
+#define DICTIONARY_WORDS(value) extern const char words[] PROGMEM = value
+#define DICTIONARY_INDEX(...) extern const uint8_t wordIndex[] PROGMEM = { __VA_ARGS__ }
 #else
 #define STRING(name, value) extern const char string_ ## name[]
 #define STRING_SIZE(name, value) STRING(name, value); static const unsigned int string_size_ ## name = sizeof(value);
+//size - of the decompressed string
+#define STRING_SIZE_DICTIONARY(name, value, size) STRING(name, value); static const unsigned int string_size_ ## name = size;
+#define DICTIONARY_WORDS(value) extern const char words[]
+#define DICTIONARY_INDEX(...) extern const uint8_t wordIndex[]
 #endif
 
 
@@ -18,14 +18,38 @@
 #include "Time.h"
 #include "Hardware.h"
 #include "atomic.h"
+#include "Profiler.h"
 
 
 // time measurement - It uses atmega32/Timer2 to measure TIMER_INTERRUPT_PERIOD_MICROSECONDS
 
 ISR(TIMER2_COMP_vect)
 {
+#ifdef ENABLE_PROFILER
+    //Time::getTicksU16() cannot be used: Time::callback() increments the interrupt counter
+    uint8_t start = TCNT2;
     Time::callback();
+    Profiler::add(Profiler::TimeInterrupt, TCNT2 - start);
+#else
+    Time::callback();
+#endif
+}
+
+#ifdef ENABLE_PROFILER
+uint16_t Time::getTicksU16()
+{
+    //Timer2 tick: clk/64
+    uint16_t t;
+    uint8_t tcnt;
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+        t = getInterruptsU16();
+        tcnt = TCNT2;
+        //compare match pending (we are in an interrupt)
+        if((TIFR & (1<<OCF2)) && tcnt < OCR2/2) t++;
+    }
+    return t * (TIMER_INTERRUPT_PERIOD_MICROSECONDS/4) + tcnt;
 }
+#endif
 
 
 void Time::initialize()
@@ -26,6 +26,7 @@
 #include "IO.h"
 #include "Settings.h"
 #include "AnalogInputsPrivate.h"
+#include "Profiler.h"
 
 //#define ENABLE_DEBUG
 #include "debug.h"
@@ -304,5 +305,7 @@ uint8_t hardware::getKeyPressed()
 
 ISR(ADC_vect)
 {
+    PROFILER_BEGIN(start);
     AnalogInputsADC::conversionDone();
+    PROFILER_END(AdcInterrupt, start);
 }
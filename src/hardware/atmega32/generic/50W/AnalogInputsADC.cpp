@@ -28,6 +28,7 @@
 #include "Timer0.h"
 #include "AnalogInputsPrivate.h"
 #include "IO.h"
+#include "Profiler.h"
 #include "SMPS.h"
 #include "Discharger.h"
 
@@ -264,8 +265,11 @@ void conversionDone()
 #endif
     case ANALOG_INPUTS_ADC_BURST_COUNT-3:
         /* update PID if necessary */
-        if(adc_input.ai_name == AnalogInputs::Ismps)
+        if(adc_input.ai_name == AnalogInputs::Ismps) {
+            PROFILER_BEGIN(start);
             SMPS_PID::update();
+            PROFILER_END(SmpsPid, start);
+        }
         break;
 
 #ifdef ENABLE_ANALOG_INPUTS_ADC_NOISE
@@ -303,7 +307,9 @@ void setupNextInput() {
 
 ISR(ADC_vect)
 {
+    PROFILER_BEGIN(start);
     AnalogInputsADC::conversionDone();
+    PROFILER_END(AdcInterrupt, start);
 }
 
 
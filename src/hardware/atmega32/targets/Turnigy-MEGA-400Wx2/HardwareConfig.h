@@ -18,6 +18,8 @@
 #ifndef HARDWARE_CONFIG_H_
 #define HARDWARE_CONFIG_H_
 
+//the flash is almost full
+#define ENABLE_STRINGS_DICTIONARY
 #include "GlobalConfig.h"
 #include "HardwareConfigGeneric.h"
 #include "GTPowerA6-10-pins.h"
@@ -18,6 +18,7 @@
 #include "Time.h"
 #include "Hardware.h"
 #include "irq_priority.h"
+#include "Profiler.h"
 
 extern "C" {
 #include "M051Series.h"
@@ -29,10 +30,20 @@ void TMR0_IRQHandler(void)
 {
     /* Clear Timer0 time-out interrupt flag */
     TIMER_ClearIntFlag(TIMER0);
+    PROFILER_BEGIN(start);
     Time::callback();
+    PROFILER_END(TimeInterrupt, start);
 }
 }
 
+#ifdef ENABLE_PROFILER
+uint16_t Time::getTicksU16()
+{
+    //SysTick counts down HCLK cycles
+    return (0xffffff - SysTick->VAL) / TIME_TICK_CYCLES;
+}
+#endif
+
 
 void Time::initialize()
 {
@@ -44,4 +55,10 @@ void Time::initialize()
     NVIC_SetPriority(TMR0_IRQn, TIMER_IRQ_PRIORITY);
     TIMER_Start(TIMER0);             /* Start counting */
 
+#ifdef ENABLE_PROFILER
+    SysTick->LOAD = 0xffffff;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+#endif
+
 }
@@ -28,6 +28,7 @@
 #include "SMPS.h"
 #include "Discharger.h"
 #include "irq_priority.h"
+#include "Profiler.h"
 
 #include "adc.h"
 
@@ -256,8 +257,11 @@ void conversionDone()
     }
     startConversion();
 
-    if(order_analogInputs_on[current_input_].trigger_PID_)
+    if(order_analogInputs_on[current_input_].trigger_PID_) {
+        PROFILER_BEGIN(start);
         SMPS_PID::update();
+        PROFILER_END(SmpsPid, start);
+    }
 
 
 }
@@ -290,6 +294,7 @@ extern "C" {
 
     void ADC_IRQHandler(void)
     {
+        PROFILER_BEGIN(start);
         while(ADC_IS_DATA_VALID2(ADC, 0)) /* Check the VALID bits */
         {
             /* In burst mode, the software always gets the conversion result of the specified channel from channel 0 */
@@ -309,5 +314,6 @@ extern "C" {
         }
 
         ADC_CLR_INT_FLAG(ADC0, ADC_ADF_INT);
+        PROFILER_END(AdcInterrupt, start);
     }
 } //extern "C"
@@ -0,0 +1,186 @@
+#!/usr/bin/python
+#
+# builds a dictionary of the most common substrings of the strings header
+# and writes a copy of the header with the substrings replaced by tokens
+# (bytes 0x80 - 0x9f, blank in the HD44780 character ROM)
+#
+# usage: generate.py <strings header> <output header>
+#
+
+from __future__ import print_function
+import re
+import sys
+
+TOKEN_FIRST = 0x80
+TOKEN_COUNT = 32
+MAX_WORD = 12
+
+string_re = re.compile(r'^(\s*)(STRING|STRING_SIZE)\((\w+),(\s*)"((?:[^"\\]|\\.)*)"\);(.*)$')
+
+
+def unescape(s):
+    out = []
+    i = 0
+    while i < len(s):
+        c = s[i]
+        if c == '\\':
+            n = s[i + 1]
+            if n == 'x':
+                m = re.match(r'[0-9a-fA-F]+', s[i + 2:])
+                out.append(int(m.group(0), 16))
+                i += 2 + len(m.group(0))
+                continue
+            out.append(ord({'n': '\n', 't': '\t', '0': '\0'}.get(n, n)))
+            i += 2
+            continue
+        out.append(ord(c))
+        i += 1
+    return out
+
+
+def escape(codes):
+    # every escaped byte ends the literal, so the next character
+    # cannot be taken as a part of the hex escape
+    out = '"'
+    for c in codes:
+        if c < 0x20 or c >= 0x7f:
+            out += '\\x%02x" "' % c
+        elif c in (ord('"'), ord('\\')):
+            out += '\\' + chr(c)
+        else:
+            out += chr(c)
+    out += '"'
+    return out.replace(' ""', '')
+
+
+def segments(codes):
+    # parts of the string not yet replaced by tokens
+    seg = []
+    for c in codes:
+        if c >= TOKEN_FIRST and c < TOKEN_FIRST + TOKEN_COUNT:
+            if seg:
+                yield seg
+            seg = []
+        else:
+            seg.append(c)
+    if seg:
+        yield seg
+
+
+def count(word, values):
+    n = 0
+    for v in values:
+        for seg in segments(v):
+            i = 0
+            while i + len(word) <= len(seg):
+                if seg[i:i + len(word)] == word:
+                    n += 1
+                    i += len(word)
+                else:
+                    i += 1
+    return n
+
+
+def replace(word, token, v):
+    out = []
+    i = 0
+    while i < len(v):
+        if v[i:i + len(word)] == word:
+            out.append(token)
+            i += len(word)
+        else:
+            out.append(v[i])
+            i += 1
+    return out
+
+
+def build(values):
+    words = []
+    while len(words) < TOKEN_COUNT:
+        candidates = set()
+        for v in values:
+            for seg in segments(v):
+                for l in range(2, MAX_WORD + 1):
+                    for i in range(len(seg) - l + 1):
+                        candidates.add(tuple(seg[i:i + l]))
+        best, best_gain = None, 0
+        for w in sorted(candidates):
+            w = list(w)
+            # each use saves len-1 bytes, the word costs: len + '\0' + index
+            gain = count(w, values) * (len(w) - 1) - (len(w) + 2)
+            if gain > best_gain:
+                best, best_gain = w, gain
+        if best is None:
+            break
+        token = TOKEN_FIRST + len(words)
+        values[:] = [replace(best, token, v) for v in values]
+        words.append(best)
+    return words
+
+
+def main():
+    src, dst = sys.argv[1], sys.argv[2]
+    lines = open(src).read().split('\n')
+
+    values = []
+    for line in lines:
+        m = string_re.match(line)
+        if m:
+            values.append(unescape(m.group(5)))
+
+    raw_size = sum(len(v) + 1 for v in values)
+    words = build(values)
+    size = sum(len(v) + 1 for v in values)
+    dictionary_size = sum(len(w) + 1 for w in words) + len(words)
+    assert dictionary_size - len(words) <= 256
+
+    out = []
+    index = 0
+    for line in lines:
+        m = string_re.match(line)
+        if m:
+            indent, macro, name, space, value, rest = m.groups()
+            encoded = escape(values[index])
+            if macro == 'STRING_SIZE':
+                line = '%sSTRING_SIZE_DICTIONARY(%s,%s%s, %d);%s' % (indent, name, space, encoded,
+                                                                      len(unescape(value)) + 1, rest)
+            else:
+                line = '%s%s(%s,%s%s);%s' % (indent, macro, name, space, encoded, rest)
+            index += 1
+        elif line.startswith('#ifndef STRINGS_H_') or line.startswith('#define STRINGS_H_'):
+            line = line.replace('STRINGS_H_', 'STRINGS_DICTIONARY_H_')
+        elif line.startswith('#endif /* STRINGS_H_ */'):
+            out.append('namespace Dictionary {')
+            out.append('    //strings: %d bytes, compressed: %d bytes + dictionary: %d bytes'
+                       % (raw_size, size, dictionary_size))
+            out.append('    DICTIONARY_WORDS(')
+            out += ['        %s "\\0"' % escape(w) for w in words]
+            out.append('    );')
+            out.append('    DICTIONARY_INDEX(')
+            offsets, offset = [], 0
+            for w in words:
+                offsets.append(str(offset))
+                offset += len(w) + 1
+            out.append('        ' + ', '.join(offsets))
+            out.append('    );')
+            out.append('}')
+            out.append('')
+            line = '#endif /* STRINGS_DICTIONARY_H_ */'
+        out.append(line)
+
+    header = [
+        '/*',
+        ' * generated by utils/stringsDictionary/generate.py from %s - do not edit' % src.split('/')[-1],
+        ' */',
+    ]
+    # keep the license header of the source
+    end = out.index('*/') + 1
+    out = out[:end] + header + out[end:]
+
+    open(dst, 'w').write('\n'.join(out))
+    print('strings: %d bytes, compressed: %d bytes, dictionary: %d bytes, saved: %d bytes'
+          % (raw_size, size, dictionary_size, raw_size - size - dictionary_size))
+
+
+if __name__ == '__main__':
+    main()